@@ -0,0 +1,140 @@
+﻿#include <iostream>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include "rglob.h"
+
+using namespace std;
+using namespace rglob;
+
+static double seconds = 0.25;	// (minimum time spent measuring each case)
+
+/*
+	The benchmarks below measure the throughput of the most common operations
+	of rglob - compiling patterns, matching targets against them, and scanning
+	whole buffers of text - and report the results as time per operation, plus
+	bytes and matches per second where these make sense.
+
+	All of the targets and corpora are generated [deterministically] here, so
+	that results may be compared between runs, builds, and machines... and any
+	argument supplied is taken as the [minimum] seconds to spend on each case.
+
+	N.B. - the "sink" totals are reported only so that the compiler can NOT
+	optimize away the work being measured.
+*/
+template<class F>
+static double measure(F&& f)
+{
+	using clock = chrono::steady_clock;
+	size_t n = 0;
+	const auto start = clock::now();
+	auto elapsed = 0.0;
+	for (size_t k = 1; elapsed < seconds; k *= 2) {
+		for (size_t i = 0; i < k; i++)
+			f();
+		n += k, elapsed = chrono::duration<double>(clock::now() - start).count();
+	}
+	return elapsed * 1e9 / n;
+}
+
+static void report(string_view what, double ns, size_t bytes, size_t matches, size_t sink)
+{
+	// (pad by code points, NOT bytes, so that non-ASCII names line up too)
+	const auto w = (size_t)count_if(what.begin(), what.end(), [](char c) { return (c & 0xc0) != 0x80; });
+	cout << "  " << what << string(w < 48 ? 48 - w : 0, ' ') << fixed << setprecision(1) << setw(12) << ns << " ns/op";
+	if (bytes != 0)
+		cout << setw(10) << bytes / ns * 1e3 << " MB/s";
+	if (matches != 0)
+		cout << setw(10) << matches / ns * 1e3 << " M/s";
+	cout << "  (sink " << sink << ')' << endl;
+}
+
+/*
+	corpus generates lines of "log-like" text, n in all - made up of words drawn
+	from the supplied list - where roughly one line in every 16 contains hit.
+*/
+static string corpus(const vector<string_view>& words, string_view hit, size_t n)
+{
+	mt19937 r(42);
+	string v;
+	for (size_t i = 0; i < n; i++) {
+		v += "2024-01-" + to_string(10 + r() % 20) + ' ';
+		for (auto k = 4 + r() % 8; k > 0; k--)
+			v.append(words[r() % words.size()]), v += ' ';
+		if (r() % 16 == 0)
+			v.append(hit), v += ' ';
+		v += to_string(r() % 100000), v += '\n';
+	}
+	return v;
+}
+
+static void benchCompile()
+{
+	cout << "compile" << endl;
+	for (const string_view p : { "*.json", "/var/log/*/error?*.txt", "*[A-Za-z0-9_][A-Za-z0-9_]*[!0-9]", "*[А-Я а-я]*[Ѐ-ӿ]bar?ε" }) {
+		size_t sink = 0;
+		glob g;
+		const auto ns = measure([&] { g.compile(p), sink += g.machine().size(); });
+		report(p, ns, 0, 0, sink);
+	}
+}
+
+static void benchMatch()
+{
+	cout << "match (M/s is of targets matched against)" << endl;
+	// (a mix of targets from a "file system", only a few of which match)
+	mt19937 r(7);
+	vector<string> ts;
+	const string_view dirs[] = { "/var/log/", "/usr/lib/x86_64-linux-gnu/", "/home/user/данные/", "/srv/www/" };
+	const string_view exts[] = { ".json", ".txt", ".so.1", ".log", ".данные" };
+	for (size_t i = 0; i < 4096; i++)
+		ts.push_back(string(dirs[r() % size(dirs)]) + "file" + to_string(r() % 100000) + string(exts[r() % size(exts)]));
+	size_t bytes = 0;
+	for (const auto& t : ts)
+		bytes += t.size();
+	const struct { string_view what, pattern; } cases[] = {
+		{ "literal-heavy", "/var/log/file1*.json" },
+		{ "star-heavy", "*/*l*o*g*/*1*" },
+		{ "ASCII-class", "*file[0-9][0-9]*[0-9].[jt][sx]*" },
+		{ "Unicode-class", "*[а-я][а-я]ные/*[0-9].[д-я]*" },
+	};
+	for (const auto& [what, pattern] : cases) {
+		const glob g(pattern);
+		size_t sink = 0;
+		const auto ns = measure([&] {
+			for (const auto& t : ts)
+				sink += g.match(trusted_utf8, t);
+		}) / ts.size();
+		report(string(what) + " " + string(pattern), ns, bytes / ts.size(), 1, sink);
+	}
+}
+
+static void benchScan()
+{
+	cout << "scan_lines (M/s is of matching lines found)" << endl;
+	const auto ascii = corpus({ "GET", "POST", "/index.html", "200", "404", "client", "upstream", "ms", "bytes", "ok" }, "error: timeout", 100000);
+	const auto mixed = corpus({ "GET", "запрос", "ответ", "200", "エラー", "客户端", "Ωμέγα", "ms", "bytes", "ok" }, "ошибка: таймаут", 100000);
+	const struct { string_view what; const string& text; string_view pattern; } cases[] = {
+		{ "ASCII literal", ascii, "*error*timeout*" },
+		{ "ASCII class", ascii, "* 40[0-9] *" },
+		{ "mixed-script literal", mixed, "*ошибка*таймаут*" },
+		{ "mixed-script class", mixed, "*[ア-ン][ア-ン]ー*" },
+	};
+	for (const auto& [what, text, pattern] : cases) {
+		const glob g(pattern);
+		size_t sink = 0;
+		const auto hits = scan_lines(g, text, [](size_t, size_t, string_view) {});
+		const auto ns = measure([&] { sink += scan_lines(g, text, [&](size_t, size_t o, string_view) { sink += o; }); });
+		report(string(what) + " " + string(pattern), ns, text.size(), hits, sink);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1)
+		seconds = atof(argv[1]);
+	benchCompile();
+	benchMatch();
+	benchScan();
+	return 0;
+}
@@ -29,11 +29,72 @@
 
 #include <string>
 #include <string_view>
-#include <bitset>
+#include <array>
+#include <bit>
+#include <span>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <memory_resource>
+#include <functional>
+#include <utility>
+#include <ranges>
+#include <initializer_list>
 #include <algorithm>
 #include <exception>
 #include <iostream>
 #include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <fstream>
+#include <stdexcept>
+
+/*
+	Unless asked not to (define RGLOB_NO_SIMD), use the vector instructions of
+	the target architecture to speed up the "bulk" scanning of text: SSE2 [and
+	AVX2 when available at run time] on x86, or NEON on 64-bit ARM.
+*/
+#if !defined(RGLOB_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RGLOB_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define RGLOB_TARGET(t)
+#else
+#define RGLOB_TARGET(t) __attribute__((target(t)))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RGLOB_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+/*
+	Unless asked not to (define RGLOB_NO_THREADED), threaded_matcher dispatches
+	its steps through the "labels as values" (computed goto) extension of GCC
+	and Clang; elsewhere it falls back to a switch.
+*/
+#if !defined(RGLOB_NO_THREADED) && (defined(__GNUC__) || defined(__clang__))
+#define RGLOB_THREADED
+#endif
+
+/*
+	Unless asked not to (define RGLOB_NO_MMAP), scan_file memory-maps the files
+	it scans where the POSIX mmap interface is available.
+*/
+#if !defined(RGLOB_NO_MMAP) && __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#define RGLOB_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using std::string;
 using std::string_view;
@@ -56,11 +117,21 @@ namespace rglob {
 #define isascii(c) ((int)(c) >= 0 && (int)(c) < 128)
 #endif
 
-constexpr size_t LengthSize = 2;		// # of chars in [base64] encoded length
-constexpr size_t AllowedMaxFSM = 4096-1;// limit [compiled] finite state machine
+constexpr size_t AllowedMaxFSM = 0xffffffff;// limit [compiled] finite state machine
+
+/*
+	Options accepted by compiler::compile (and glob::compile), combined with '|'.
+*/
+enum options : unsigned {
+	defaults = 0,
+	binary = 1 << 0,					// emit "binary" (NOT text) machine
+	ignore_case = 1 << 1,				// match letters of EITHER case
+};
 
 // (internally used definitions not intended to appear in the rglob namespace)
 namespace detail {
+	constexpr char32_t MaxCodePoint = 0x1fffff;	// (most that 4-byte UTF-8 holds)
+
 	/*
 		sizeOfUTF8CodePoint returns the length in bytes of a UTF-8 code point, based
 		on being passed the [presumed] first byte.
@@ -107,15 +178,16 @@ namespace detail {
 	}
 
 	/*
-		validateUTF8String evaluates the [NUL-terminated] sequence of chars supplied
-		for "valid" UTF-8 encoding - structurally, NOT in terms of specific values
-		of code points / combinations.
+		validateUTF8Scalar evaluates the sequence of chars supplied for "valid" UTF-8
+		encoding - structurally, NOT in terms of specific values of code points /
+		combinations - one char at a time.
 
 		Returns the result of this evaluation.
 
-		N.B. - a "false" return should probably NOT be ignored.
+		N.B. - this is the "reference" implementation, and also the one used when
+		evaluated at compile time... otherwise, see validateUTF8String (below).
 	*/
-	constexpr auto validateUTF8String(string_view v)
+	constexpr auto validateUTF8Scalar(string_view v)
 	{
 		for (auto i = v.cbegin(); i != v.cend();)
 			switch (auto n = sizeOfUTF8CodePoint(*i++); n) {
@@ -138,6 +210,565 @@ namespace detail {
 		return true;
 	}
 
+	/*
+		classBits is a [minimal] 128-bit set, used for the "fast path" (ASCII-only)
+		character classes... unlike std::bitset, it is usable in constant [compile
+		time] evaluation as of C++ 20.
+	*/
+	struct classBits
+	{
+		std::uint64_t w[2]{};
+
+		constexpr bool test(size_t i) const noexcept { return (w[i >> 6] >> (i & 63) & 1) != 0; }
+		constexpr void flip(size_t i) noexcept { w[i >> 6] ^= (std::uint64_t)1 << (i & 63); }
+		constexpr void flip() noexcept { w[0] = ~w[0], w[1] = ~w[1]; }
+		constexpr void set(size_t i) noexcept { w[i >> 6] |= (std::uint64_t)1 << (i & 63); }
+		constexpr void set() noexcept { w[0] = w[1] = ~(std::uint64_t)0; }
+		constexpr int count() const noexcept { return std::popcount(w[0]) + std::popcount(w[1]); }
+		constexpr int first() const noexcept { return w[0] != 0 ? std::countr_zero(w[0]) : 64 + std::countr_zero(w[1]); }
+	};
+
+	/*
+		classTable holds the same set of ASCII chars as a classBits, but arranged
+		for "nibble-table" lookups (see findInClass): bit h of rows[l] is set if
+		the char with high nibble h and low nibble l is a member.
+	*/
+	struct classTable
+	{
+		std::uint8_t rows[16]{};
+
+		constexpr classTable() = default;
+		constexpr explicit classTable(const classBits& b) noexcept {
+			for (size_t c = 0; c < 128; c++)
+				if (b.test(c))
+					rows[c & 15] |= (std::uint8_t)(1 << (c >> 4));
+		}
+		constexpr bool test(char32_t c) const noexcept { return c < 128 && (rows[c & 15] >> (c >> 4) & 1) != 0; }
+	};
+
+	/*
+		inRanges returns whether c falls in one of the [sorted and disjoint] ranges
+		of code points between first and last - as produced for any "interpreted"
+		character class by compiler::normalizeClass - by binary search.
+	*/
+	template<class It>
+	constexpr bool inRanges(It first, It last, char32_t c) noexcept
+	{
+		const auto r = std::partition_point(first, last, [=](const auto& x) { return x.second < c; });
+		return r != last && r->first <= c;
+	}
+
+	/*
+		caseRanges lists the simple (1:1) case mappings used by the ignore_case
+		option, for the letters of the ASCII, Latin-1, Latin Extended-A, Greek,
+		Cyrillic, Armenian, and "fullwidth" Latin blocks: each code point in the
+		range [first, last] has delta added to give its other case... except that
+		a delta of 0 marks a range of alternating upper / lower case pairs.
+
+		N.B. - letters with NO such simple mapping (e.g., 'ß', or final sigma) are
+		deliberately NOT listed, and so only ever match themselves.
+	*/
+	struct caseRange
+	{
+		char32_t first, last;
+		std::int32_t delta;
+	};
+	constexpr caseRange caseRanges[] = {
+		{ 0x0041, 0x005a, 32 }, { 0x0061, 0x007a, -32 },
+		{ 0x00c0, 0x00d6, 32 }, { 0x00d8, 0x00de, 32 }, { 0x00e0, 0x00f6, -32 }, { 0x00f8, 0x00fe, -32 },
+		{ 0x00ff, 0x00ff, 0x79 }, { 0x0178, 0x0178, -0x79 },
+		{ 0x0100, 0x012f, 0 }, { 0x0132, 0x0137, 0 }, { 0x0139, 0x0148, 0 }, { 0x014a, 0x0177, 0 }, { 0x0179, 0x017e, 0 },
+		{ 0x0386, 0x0386, 38 }, { 0x03ac, 0x03ac, -38 }, { 0x0388, 0x038a, 37 }, { 0x03ad, 0x03af, -37 },
+		{ 0x038c, 0x038c, 64 }, { 0x03cc, 0x03cc, -64 }, { 0x038e, 0x038f, 63 }, { 0x03cd, 0x03ce, -63 },
+		{ 0x0391, 0x03a1, 32 }, { 0x03a3, 0x03ab, 32 }, { 0x03b1, 0x03c1, -32 }, { 0x03c3, 0x03cb, -32 },
+		{ 0x0400, 0x040f, 80 }, { 0x0410, 0x042f, 32 }, { 0x0430, 0x044f, -32 }, { 0x0450, 0x045f, -80 },
+		{ 0x0460, 0x0481, 0 }, { 0x048a, 0x04bf, 0 }, { 0x04c1, 0x04ce, 0 }, { 0x04d0, 0x052f, 0 },
+		{ 0x0531, 0x0556, 48 }, { 0x0561, 0x0586, -48 },
+		{ 0xff21, 0xff3a, 32 }, { 0xff41, 0xff5a, -32 },
+	};
+
+#if defined(RGLOB_SIMD_X86)
+	/*
+		cpuHasAVX2 determines [once] whether the AVX2 instructions are available to
+		us at run time - which requires support from BOTH the CPU and the OS.
+	*/
+	inline bool cpuHasAVX2() noexcept
+	{
+		static const bool avx2 = [] {
+#if defined(_MSC_VER) && !defined(__clang__)
+			int r[4];
+			__cpuid(r, 0);
+			if (r[0] < 7)
+				return false;
+			__cpuid(r, 1);
+			if ((r[2] & (1 << 27)) == 0 || (r[2] & (1 << 28)) == 0 || (_xgetbv(0) & 0b110) != 0b110)
+				return false;
+			__cpuidex(r, 7, 0);
+			return (r[1] & (1 << 5)) != 0;
+#else
+			return __builtin_cpu_supports("avx2") != 0;
+#endif
+		}();
+		return avx2;
+	}
+
+	/*
+		cpuHasSSSE3 is as for cpuHasAVX2 (above), but for SSSE3 - which needs NO
+		support from the OS, beyond that for SSE2.
+	*/
+	inline bool cpuHasSSSE3() noexcept
+	{
+		static const bool ssse3 = [] {
+#if defined(_MSC_VER) && !defined(__clang__)
+			int r[4];
+			__cpuid(r, 1);
+			return (r[2] & (1 << 9)) != 0;
+#else
+			return __builtin_cpu_supports("ssse3") != 0;
+#endif
+		}();
+		return ssse3;
+	}
+#endif
+
+	/*
+		asciiPrefix returns the number of leading ASCII chars in the n chars at p,
+		examining 32 (AVX2) or 16 (SSE2/NEON) chars at a time if it can, else 8 in
+		a "SWAR" fashion... the variants are selected by the [run-time] dispatcher
+		at the end, with asciiPrefixScalar always available as the fallback.
+	*/
+	inline size_t asciiPrefixScalar(const char* p, size_t n) noexcept
+	{
+		size_t i = 0;
+		for (std::uint64_t w; i + sizeof w <= n; i += sizeof w)
+			if (std::memcpy(&w, p + i, sizeof w), (w & 0x8080808080808080) != 0)
+				break;
+		while (i < n && isascii(p[i]))
+			i++;
+		return i;
+	}
+
+	/*
+		findChar returns the position of the first c in the n chars at p (or n if
+		there isn't one), with the same set of variants and dispatching as for
+		asciiPrefix - the "SWAR" version detects a zero byte in w XOR c's.
+	*/
+	inline size_t findCharScalar(const char* p, size_t n, char c) noexcept
+	{
+		constexpr std::uint64_t ones = 0x0101010101010101, highs = 0x8080808080808080;
+		const auto cs = ones * (unsigned char)c;
+		size_t i = 0;
+		for (std::uint64_t w; i + sizeof w <= n; i += sizeof w)
+			if (std::memcpy(&w, p + i, sizeof w), w ^= cs, ((w - ones) & ~w & highs) != 0)
+				break;
+		while (i < n && p[i] != c)
+			i++;
+		return i;
+	}
+
+	/*
+		findString returns the position of the first occurrence of the k (>= 2)
+		chars at v in the n chars at h (or string::npos if there isn't one), with
+		the same set of variants and dispatching as for asciiPrefix.
+
+		The vector variants first look for places where BOTH the first and the
+		last chars of v occur the right distance apart (for 32 or 16 places at a
+		time), and only then compare the chars in between... which rejects most
+		"false starts" far more cheaply than a memchr-then-compare search does.
+	*/
+	inline size_t findStringScalar(const char* h, size_t n, const char* v, size_t k) noexcept
+	{
+		return string_view(h, n).find(string_view(v, k));
+	}
+
+	/*
+		equalFolded and findFolded are the counterparts of a simple compare and of
+		findString that ignore ASCII case: the k chars at v must already be folded
+		(i.e., contain NO ASCII upper case letters), while the chars they are
+		compared with are folded as they are loaded - and any non-ASCII chars are
+		compared exactly... the same set of variants and dispatching is used for
+		findFolded as for asciiPrefix, while equalFolded [which is typically used
+		for SHORT compares] only has its "SWAR" version.
+
+		The "SWAR" fold finds the upper case letters among 8 chars at a time by
+		adding to their low 7 bits - so that bit 7 of each char is then set if it
+		was >= 'A', or > 'Z' - and ORing 0x20 into each one found.
+	*/
+	constexpr char foldASCII(char c) noexcept { return c >= 'A' && c <= 'Z' ? (char)(c | 0x20) : c; }
+	constexpr char32_t foldASCII(char32_t c) noexcept { return c >= 'A' && c <= 'Z' ? c | 0x20 : c; }
+
+	inline std::uint64_t foldSWAR(std::uint64_t w) noexcept
+	{
+		constexpr std::uint64_t ones = 0x0101010101010101, highs = 0x8080808080808080;
+		const auto x = w & ~highs;
+		const auto ge = x + ones * (0x80 - 'A'), gt = x + ones * (0x80 - 'Z' - 1);
+		return w | (ge & ~gt & ~w & highs) >> 2;
+	}
+
+	inline bool equalFolded(const char* p, const char* v, size_t k) noexcept
+	{
+		size_t i = 0;
+		for (std::uint64_t w, u; i + sizeof w <= k; i += sizeof w)
+			if (std::memcpy(&w, p + i, sizeof w), std::memcpy(&u, v + i, sizeof u), foldSWAR(w) != u)
+				return false;
+		for (; i < k; i++)
+			if (foldASCII(p[i]) != v[i])
+				return false;
+		return true;
+	}
+
+	inline size_t findFoldedScalar(const char* h, size_t n, const char* v, size_t k) noexcept
+	{
+		for (size_t i = 0; k <= n && i <= n - k; i++)
+			if (foldASCII(h[i]) == v[0] && equalFolded(h + i + 1, v + 1, k - 1))
+				return i;
+		return string::npos;
+	}
+
+	/*
+		findInClass returns the position of the first of the n chars at p which is
+		a member of the "fast path" class t (or n if there isn't one), with the
+		same set of variants and dispatching as for asciiPrefix (except that x86
+		requires SSSE3, NOT just SSE2).
+
+		The vector variants look up the row for the low nibble of each of 32 or 16
+		chars at a time, and the bit for the high nibble in that row... where the
+		high nibbles of non-ASCII chars (8-f) select NO bits - as no multi-byte
+		UTF-8 code point can ever be a member of a "fast path" class, this makes a
+		byte-at-a-time search return ONLY the positions of [ASCII] code points.
+	*/
+	inline size_t findInClassScalar(const char* p, size_t n, const classTable& t) noexcept
+	{
+		size_t i = 0;
+		while (i < n && !t.test((unsigned char)p[i]))
+			i++;
+		return i;
+	}
+
+#if defined(RGLOB_SIMD_X86)
+	// (GCC may warn on vector loads that it "sees" past the end of SHORT constant
+	// strings - even though the loop conditions below make them unreachable)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+	inline size_t asciiPrefixSSE2(const char* p, size_t n) noexcept
+	{
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16)
+			if (const auto m = (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(p + i))); m != 0)
+				return i + std::countr_zero(m);
+		return i + asciiPrefixScalar(p + i, n - i);
+	}
+
+	RGLOB_TARGET("avx2") inline size_t asciiPrefixAVX2(const char* p, size_t n) noexcept
+	{
+		size_t i = 0;
+		for (; i + 32 <= n; i += 32)
+			if (const auto m = (unsigned)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(p + i))); m != 0)
+				return i + std::countr_zero(m);
+		return i + asciiPrefixSSE2(p + i, n - i);
+	}
+
+	inline size_t findCharSSE2(const char* p, size_t n, char c) noexcept
+	{
+		const auto cs = _mm_set1_epi8(c);
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16)
+			if (const auto m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + i)), cs)); m != 0)
+				return i + std::countr_zero(m);
+		return i + findCharScalar(p + i, n - i, c);
+	}
+
+	RGLOB_TARGET("avx2") inline size_t findCharAVX2(const char* p, size_t n, char c) noexcept
+	{
+		const auto cs = _mm256_set1_epi8(c);
+		size_t i = 0;
+		for (; i + 32 <= n; i += 32)
+			if (const auto m = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i)), cs)); m != 0)
+				return i + std::countr_zero(m);
+		return i + findCharSSE2(p + i, n - i, c);
+	}
+
+	inline size_t findStringSSE2(const char* h, size_t n, const char* v, size_t k) noexcept
+	{
+		const auto first = _mm_set1_epi8(v[0]), last = _mm_set1_epi8(v[k - 1]);
+		size_t i = 0;
+		for (; i + k - 1 + 16 <= n; i += 16) {
+			const auto b0 = _mm_loadu_si128((const __m128i*)(h + i)), b1 = _mm_loadu_si128((const __m128i*)(h + i + k - 1));
+			for (auto m = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(b0, first), _mm_cmpeq_epi8(b1, last))); m != 0; m &= m - 1)
+				if (const auto j = i + std::countr_zero(m); std::memcmp(h + j + 1, v + 1, k - 2) == 0)
+					return j;
+		}
+		const auto j = findStringScalar(h + i, n - i, v, k);
+		return j == string::npos ? j : i + j;
+	}
+
+	RGLOB_TARGET("avx2") inline size_t findStringAVX2(const char* h, size_t n, const char* v, size_t k) noexcept
+	{
+		const auto first = _mm256_set1_epi8(v[0]), last = _mm256_set1_epi8(v[k - 1]);
+		size_t i = 0;
+		for (; i + k - 1 + 32 <= n; i += 32) {
+			const auto b0 = _mm256_loadu_si256((const __m256i*)(h + i)), b1 = _mm256_loadu_si256((const __m256i*)(h + i + k - 1));
+			for (auto m = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(b0, first), _mm256_cmpeq_epi8(b1, last))); m != 0; m &= m - 1)
+				if (const auto j = i + std::countr_zero(m); std::memcmp(h + j + 1, v + 1, k - 2) == 0)
+					return j;
+		}
+		const auto j = findStringSSE2(h + i, n - i, v, k);
+		return j == string::npos ? j : i + j;
+	}
+
+	// (signed compare... ONLY 'A' to 'Z' are mapped below -128 + 26 by the add)
+	inline __m128i foldSSE2(__m128i x) noexcept
+	{
+		const auto upper = _mm_cmplt_epi8(_mm_add_epi8(x, _mm_set1_epi8((char)(0x80 - 'A'))), _mm_set1_epi8((char)(0x80 + 26)));
+		return _mm_or_si128(x, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+	}
+
+	RGLOB_TARGET("avx2") inline __m256i foldAVX2(__m256i x) noexcept
+	{
+		const auto upper = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(0x80 + 26)), _mm256_add_epi8(x, _mm256_set1_epi8((char)(0x80 - 'A'))));
+		return _mm256_or_si256(x, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+	}
+
+	inline size_t findFoldedSSE2(const char* h, size_t n, const char* v, size_t k) noexcept
+	{
+		const auto first = _mm_set1_epi8(v[0]), last = _mm_set1_epi8(v[k - 1]);
+		size_t i = 0;
+		for (; i + k - 1 + 16 <= n; i += 16) {
+			const auto b0 = foldSSE2(_mm_loadu_si128((const __m128i*)(h + i))), b1 = foldSSE2(_mm_loadu_si128((const __m128i*)(h + i + k - 1)));
+			for (auto m = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(b0, first), _mm_cmpeq_epi8(b1, last))); m != 0; m &= m - 1)
+				if (const auto j = i + std::countr_zero(m); k <= 2 || equalFolded(h + j + 1, v + 1, k - 2))
+					return j;
+		}
+		const auto j = findFoldedScalar(h + i, n - i, v, k);
+		return j == string::npos ? j : i + j;
+	}
+
+	RGLOB_TARGET("avx2") inline size_t findFoldedAVX2(const char* h, size_t n, const char* v, size_t k) noexcept
+	{
+		const auto first = _mm256_set1_epi8(v[0]), last = _mm256_set1_epi8(v[k - 1]);
+		size_t i = 0;
+		for (; i + k - 1 + 32 <= n; i += 32) {
+			const auto b0 = foldAVX2(_mm256_loadu_si256((const __m256i*)(h + i))), b1 = foldAVX2(_mm256_loadu_si256((const __m256i*)(h + i + k - 1)));
+			for (auto m = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(b0, first), _mm256_cmpeq_epi8(b1, last))); m != 0; m &= m - 1)
+				if (const auto j = i + std::countr_zero(m); k <= 2 || equalFolded(h + j + 1, v + 1, k - 2))
+					return j;
+		}
+		const auto j = findFoldedSSE2(h + i, n - i, v, k);
+		return j == string::npos ? j : i + j;
+	}
+
+	RGLOB_TARGET("ssse3") inline size_t findInClassSSSE3(const char* p, size_t n, const classTable& t) noexcept
+	{
+		const auto rows = _mm_loadu_si128((const __m128i*)t.rows);
+		const auto bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+		const auto nibble = _mm_set1_epi8(0x0f);
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			const auto x = _mm_loadu_si128((const __m128i*)(p + i));
+			const auto row = _mm_shuffle_epi8(rows, _mm_and_si128(x, nibble));
+			const auto bit = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(x, 4), nibble));
+			// (N.B. - the mask of NON-members is the complement of the members')
+			if (const auto m = ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), _mm_setzero_si128())) & 0xffff; m != 0)
+				return i + std::countr_zero(m);
+		}
+		return i + findInClassScalar(p + i, n - i, t);
+	}
+
+	RGLOB_TARGET("avx2") inline size_t findInClassAVX2(const char* p, size_t n, const classTable& t) noexcept
+	{
+		const auto rows = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)t.rows));
+		const auto bits = _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0));
+		const auto nibble = _mm256_set1_epi8(0x0f);
+		size_t i = 0;
+		for (; i + 32 <= n; i += 32) {
+			const auto x = _mm256_loadu_si256((const __m256i*)(p + i));
+			const auto row = _mm256_shuffle_epi8(rows, _mm256_and_si256(x, nibble));
+			const auto bit = _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+			if (const auto m = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), _mm256_setzero_si256())); m != 0)
+				return i + std::countr_zero(m);
+		}
+		return i + findInClassSSSE3(p + i, n - i, t);
+	}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#elif defined(RGLOB_SIMD_NEON)
+	inline size_t asciiPrefixNEON(const char* p, size_t n) noexcept
+	{
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16)
+			if ((vmaxvq_u8(vld1q_u8((const std::uint8_t*)(p + i))) & 0x80) != 0)
+				break;
+		return i + asciiPrefixScalar(p + i, n - i);
+	}
+
+	inline size_t findCharNEON(const char* p, size_t n, char c) noexcept
+	{
+		const auto cs = vdupq_n_u8((std::uint8_t)c);
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16)
+			if (vmaxvq_u8(vceqq_u8(vld1q_u8((const std::uint8_t*)(p + i)), cs)) != 0)
+				break;
+		return i + findCharScalar(p + i, n - i, c);
+	}
+
+	inline size_t findStringNEON(const char* h, size_t n, const char* v, size_t k) noexcept
+	{
+		const auto first = vdupq_n_u8((std::uint8_t)v[0]), last = vdupq_n_u8((std::uint8_t)v[k - 1]);
+		size_t i = 0;
+		for (; i + k - 1 + 16 <= n; i += 16) {
+			const auto b0 = vld1q_u8((const std::uint8_t*)(h + i)), b1 = vld1q_u8((const std::uint8_t*)(h + i + k - 1));
+			const auto eq = vandq_u8(vceqq_u8(b0, first), vceqq_u8(b1, last));
+			// (narrow the 16 byte-wide lanes to a 64-bit mask with 4 bits per lane)
+			for (auto m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0); m != 0; m &= ~((std::uint64_t)0xf << (std::countr_zero(m) & ~3)))
+				if (const auto j = i + std::countr_zero(m) / 4; std::memcmp(h + j + 1, v + 1, k - 2) == 0)
+					return j;
+		}
+		const auto j = findStringScalar(h + i, n - i, v, k);
+		return j == string::npos ? j : i + j;
+	}
+
+	inline uint8x16_t foldNEON(uint8x16_t x) noexcept
+	{
+		const auto upper = vcltq_u8(vsubq_u8(x, vdupq_n_u8('A')), vdupq_n_u8(26));
+		return vorrq_u8(x, vandq_u8(upper, vdupq_n_u8(0x20)));
+	}
+
+	inline size_t findFoldedNEON(const char* h, size_t n, const char* v, size_t k) noexcept
+	{
+		const auto first = vdupq_n_u8((std::uint8_t)v[0]), last = vdupq_n_u8((std::uint8_t)v[k - 1]);
+		size_t i = 0;
+		for (; i + k - 1 + 16 <= n; i += 16) {
+			const auto b0 = foldNEON(vld1q_u8((const std::uint8_t*)(h + i))), b1 = foldNEON(vld1q_u8((const std::uint8_t*)(h + i + k - 1)));
+			const auto eq = vandq_u8(vceqq_u8(b0, first), vceqq_u8(b1, last));
+			for (auto m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0); m != 0; m &= ~((std::uint64_t)0xf << (std::countr_zero(m) & ~3)))
+				if (const auto j = i + std::countr_zero(m) / 4; k <= 2 || equalFolded(h + j + 1, v + 1, k - 2))
+					return j;
+		}
+		const auto j = findFoldedScalar(h + i, n - i, v, k);
+		return j == string::npos ? j : i + j;
+	}
+
+	inline size_t findInClassNEON(const char* p, size_t n, const classTable& t) noexcept
+	{
+		const auto rows = vld1q_u8(t.rows);
+		constexpr std::uint8_t b[16] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+		const auto bits = vld1q_u8(b);
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			const auto x = vld1q_u8((const std::uint8_t*)(p + i));
+			const auto in = vtstq_u8(vqtbl1q_u8(rows, vandq_u8(x, vdupq_n_u8(0x0f))), vqtbl1q_u8(bits, vshrq_n_u8(x, 4)));
+			if (vmaxvq_u8(in) != 0)
+				break;
+		}
+		return i + findInClassScalar(p + i, n - i, t);
+	}
+#endif
+
+	inline size_t asciiPrefix(const char* p, size_t n) noexcept
+	{
+#if defined(RGLOB_SIMD_X86)
+		return cpuHasAVX2() ? asciiPrefixAVX2(p, n) : asciiPrefixSSE2(p, n);
+#elif defined(RGLOB_SIMD_NEON)
+		return asciiPrefixNEON(p, n);
+#else
+		return asciiPrefixScalar(p, n);
+#endif
+	}
+
+	inline size_t findChar(const char* p, size_t n, char c) noexcept
+	{
+#if defined(RGLOB_SIMD_X86)
+		return cpuHasAVX2() ? findCharAVX2(p, n, c) : findCharSSE2(p, n, c);
+#elif defined(RGLOB_SIMD_NEON)
+		return findCharNEON(p, n, c);
+#else
+		return findCharScalar(p, n, c);
+#endif
+	}
+
+	inline size_t findInClass(const char* p, size_t n, const classTable& t) noexcept
+	{
+#if defined(RGLOB_SIMD_X86)
+		return cpuHasAVX2() ? findInClassAVX2(p, n, t) : cpuHasSSSE3() ? findInClassSSSE3(p, n, t) : findInClassScalar(p, n, t);
+#elif defined(RGLOB_SIMD_NEON)
+		return findInClassNEON(p, n, t);
+#else
+		return findInClassScalar(p, n, t);
+#endif
+	}
+
+	constexpr size_t findString(string_view t, string_view v, size_t o)
+	{
+		if (std::is_constant_evaluated() || v.empty() || o > t.size() || v.size() > t.size() - o)
+			return t.find(v, o);
+		const auto h = t.data() + o;
+		const auto n = t.size() - o;
+		if (v.size() == 1) {
+			const auto j = findChar(h, n, v.front());
+			return j == n ? string::npos : o + j;
+		}
+#if defined(RGLOB_SIMD_X86)
+		const auto j = cpuHasAVX2() ? findStringAVX2(h, n, v.data(), v.size()) : findStringSSE2(h, n, v.data(), v.size());
+#elif defined(RGLOB_SIMD_NEON)
+		const auto j = findStringNEON(h, n, v.data(), v.size());
+#else
+		const auto j = findStringScalar(h, n, v.data(), v.size());
+#endif
+		return j == string::npos ? j : o + j;
+	}
+
+	inline size_t findFolded(string_view t, string_view v, size_t o) noexcept
+	{
+		if (v.empty() || o > t.size() || v.size() > t.size() - o)
+			return v.empty() && o <= t.size() ? o : string::npos;
+		const auto h = t.data() + o;
+		const auto n = t.size() - o;
+#if defined(RGLOB_SIMD_X86)
+		const auto j = cpuHasAVX2() ? findFoldedAVX2(h, n, v.data(), v.size()) : findFoldedSSE2(h, n, v.data(), v.size());
+#elif defined(RGLOB_SIMD_NEON)
+		const auto j = findFoldedNEON(h, n, v.data(), v.size());
+#else
+		const auto j = findFoldedScalar(h, n, v.data(), v.size());
+#endif
+		return j == string::npos ? j : o + j;
+	}
+
+	/*
+		validateUTF8String evaluates the sequence of chars supplied for "valid" UTF-8
+		encoding - structurally, NOT in terms of specific values of code points /
+		combinations.
+
+		Returns the result of this evaluation.
+
+		Runs of ASCII chars (expected to be the most common case by far) are skipped
+		over using asciiPrefix, so that only the non-ASCII code points are examined
+		individually - i.e., all-ASCII text is "validated" at vector speeds.
+
+		N.B. - a "false" return should probably NOT be ignored.
+	*/
+	constexpr auto validateUTF8String(string_view v)
+	{
+		if (std::is_constant_evaluated())
+			return validateUTF8Scalar(v);
+		for (size_t i = 0; (i += asciiPrefix(v.data() + i, v.size() - i)) < v.size();)
+			// validate [multi-byte] code points until we are back to ASCII chars
+			do {
+				const auto n = sizeOfUTF8CodePoint(v[i]);
+				if (n == 0 || n > v.size() - i)
+					// invalid "lead char" OR truncated UTF-8 Unicode sequence
+					return false;
+				for (size_t k = 1; k < n; k++)
+					if ((v[i + k] & 0b11000000) != 0b10000000)
+						// invalid "following char" of UTF-8 Unicode sequence
+						return false;
+				i += n;
+			} while (i < v.size() && !isascii(v[i]));
+		return true;
+	}
+
 	/*
 		codePointToUTF8 is a template function providing flexible output options for
 		the encoded UTF-8 chars representing the supplied Unicode code point.
@@ -173,8 +804,76 @@ namespace detail {
 			f((char)(((c >> 6) & 0b111111) | 0b10000000)),
 			f((char)((c & 0b111111) | 0b10000000));
 	}
+
+	/*
+		wideCodeUnit is satisfied by the code unit types of the "wide" encodings of
+		Unicode that targets may ALSO be matched in: UTF-16 (char16_t, and wchar_t
+		where it is 16 bits) and UTF-32 (char32_t, and wchar_t where it is 32).
+	*/
+	template<class T>
+	concept wideCodeUnit = std::same_as<T, char16_t> || std::same_as<T, char32_t> || std::same_as<T, wchar_t>;
+
+	/*
+		sizeInUTF8 evaluates the sequence of [UTF-16 or UTF-32] code units from i
+		to e for valid encoding - structurally, as does validateUTF8String - and
+		returns the number of BYTEs it would take in UTF-8, or npos if invalid.
+	*/
+	template<class Iterator>
+	constexpr size_t sizeInUTF8(Iterator i, Iterator e) noexcept
+	{
+		size_t n = 0;
+		while (i != e)
+			if constexpr (sizeof(*i) == sizeof(char16_t)) {
+				if (const char32_t c = (char16_t)*i++; c < 0xd800 || c > 0xdfff)
+					n += c < 0x80 ? 1 : c < 0x800 ? 2 : 3;
+				else if (c > 0xdbff || i == e || ((char16_t)*i & 0xfc00) != 0xdc00)
+					// unpaired [high or low] surrogate
+					return string::npos;
+				else
+					++i, n += 4;
+			} else {
+				const auto c = (char32_t)*i++;
+				if (c > MaxCodePoint)
+					return string::npos;
+				n += c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+			}
+		return n;
+	}
+}
+
+/*
+	validate_utf8 makes the same *structural* UTF-8 check that is performed on
+	every pattern passed to compile and every target passed to match, over an
+	entire buffer in a single pass - typically to "clear" a whole block of text
+	at ingest time, from which [string_view] targets will later be taken.
+
+	N.B. - the targets taken from a buffer validated like this are themselves
+	valid UTF-8 ONLY if they neither begin nor end in the middle of a code point
+	(which is trivially true if they are delimited by ASCII chars, e.g., '\n').
+*/
+inline bool validate_utf8(string_view buffer) noexcept { return detail::validateUTF8String(buffer); }
+
+/*
+	find_invalid_utf8 performs the same check as validate_utf8 over each of the
+	supplied targets in turn, returning the index of the first target which is
+	NOT valid UTF-8 - or targets.size() if all of them are.
+*/
+inline size_t find_invalid_utf8(std::span<const string_view> targets) noexcept
+{
+	return std::find_if(targets.begin(), targets.end(), [](string_view t) { return !detail::validateUTF8String(t); }) - targets.begin();
 }
 
+/*
+	trusted_utf8 is a "tag" value used to select the overloads of match which do
+	NOT [re-]validate their target text as UTF-8 - useful when this has already
+	been done, e.g., by validate_utf8 or find_invalid_utf8 (above).
+
+	N.B. - the results of matching invalid UTF-8 with these overloads are NOT
+	defined, and this includes possibly reading past the end of the target!
+*/
+struct trusted_utf8_t { explicit trusted_utf8_t() = default; };
+inline constexpr trusted_utf8_t trusted_utf8{};
+
 /*
 	basic_utf8iterator is an iterator adaptor template class providing read-only
 	operations over a "base" character iterator type on text containing Unicode
@@ -260,9 +959,9 @@ public:
 	// - this is a C++ language/stdlib issue - we delete the default ctor, and
 	// require apps to explictily employ only valid copy-constructor exprs
 	basic_utf8iterator() = delete;
-	basic_utf8iterator(const T& u) : base(u.base) {}
-	basic_utf8iterator(base_type i) : base(i) {}
-	~basic_utf8iterator() {}
+	constexpr basic_utf8iterator(const T& u) : base(u.base) {}
+	constexpr basic_utf8iterator(base_type i) : base(i) {}
+	constexpr ~basic_utf8iterator() {}
 
 	// provide [expert] access to "base" iterator member
 	constexpr operator base_type() const { return base; }
@@ -315,32 +1014,329 @@ typedef basic_utf8iterator<string_view::const_iterator> utf8iterator;
 typedef basic_utf8iterator<const char*> utf8iteratorBare;
 
 /*
-	The compiler class is composed of a primary function - compile - which takes
-	a "pattern" specification in the style of the "glob" patterns of Unix/Linux,
-	and machine, a "payload" function that returns the now-compiled pattern for
-	subsequent display or execution by the matcher class.
-
-	All text is expected to be in UTF-8 representation, which is usable and at
-	least minimally supported by modern C++ compilers... without attempting to
-	be a tutorial on the UTF-8 Unicode encoding, we can observe the following:
+	basic_utf16iterator is the equivalent iterator adaptor template class for
+	text containing Unicode represented in the UTF-16 encoding - typically with
+	a std::u16string_view::const_iterator (or "bare" const char16_t*) as the
+	underlying code unit iterator type, although any forward iterator over
+	char16_t (or 16-bit wchar_t) code units will do, e.g., that of a std::deque
+	or of some "rope" or segmented buffer.
 
-	* Unicode is a set of over a million characters ("everything"), and UTF-8
-	is a way of representing Unicode "code points" as 1, 2, 3, or 4 bytes
+	As it need only decode [surrogate pairs] going forward, it is just a forward
+	iterator... and as with basic_utf8iterator, it works ONLY with well-formed
+	data (see detail::sizeInUTF8).
 
-	* 7-bit ASCII is the first 128 characters of Unicode, and appears unchanged
-	in UTF-8... another way to say this is that ASCII chars ARE UTF-8 chars
+	N.B. - UTF-32 text needs no such adaptor, as its code units ARE code points.
+*/
+template<class BaseIteratorType>
+class basic_utf16iterator
+{
+	// provide [internal] short-hand access to our value and instantiated types
+	using _Ty = char32_t;
+	using T = basic_utf16iterator<BaseIteratorType>;
 
-	* 2nd, 3rd, or 4th chars in Unicode code points will NEVER look like an
-	ASCII char, so one can still perform "normal" text comparisons or even
-	make use of the standard C++ library with UTF-8 text
+	BaseIteratorType base;						// our actual "base" iterator
 
-	* if you want to include non-ASCII text literals in C++ source, you have
-	the choice of doing it the hard way with hex/binary escaped sequences in
-	strings, \unnnn sequences in strings for 2/3-byte code points, \Unnnnnnnn
-	sequences in strings for 3-byte or 4-byte code points, or [easiest] using
-	the new UTF-8 string literals: u8"This is a UTF-8 string!"
+	static constexpr bool isHighSurrogate(_Ty c) noexcept { return c >= 0xd800 && c <= 0xdbff; }
 
-	* to see FAR more detail on this, visit http://utf8everywhere.org/
+public:
+	// provide public access to our constituent types
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = _Ty;
+	using difference_type = ptrdiff_t;
+	using pointer = value_type *;
+	using reference = value_type &;
+
+	// provide public access to our instantiated base type
+	using base_type = BaseIteratorType;
+
+	// define "standard" constructors/destructor for iterators (see above)
+	basic_utf16iterator() = delete;
+	constexpr basic_utf16iterator(const T& u) : base(u.base) {}
+	constexpr basic_utf16iterator(base_type i) : base(i) {}
+	constexpr ~basic_utf16iterator() {}
+
+	// provide [expert] access to "base" iterator member
+	constexpr operator base_type() const { return base; }
+
+	// define "copy assignment" operator for iterators
+	constexpr T& operator=(const T& u) { base = u.base; return *this; }
+
+	// define "dereferencing" operator for iterators (assembling any surrogate
+	// pair into the full [32-bit] Unicode code point)
+	constexpr value_type operator*() const {
+		const _Ty c = (char16_t)*base;
+		return isHighSurrogate(c) ? 0x10000 + ((c - 0xd800) << 10) + ((char16_t)*std::next(base) - 0xdc00) : c;
+	}
+
+	// define "pre- and post- increment" operators for iterators
+	constexpr T& operator++() {
+		if (isHighSurrogate((char16_t)*base))
+			++base;
+		++base;
+		return *this;
+	}
+	constexpr T operator++(int) { auto u = *this; ++(*this); return u; }
+
+	// define "relational" operators for iterators in same container
+	constexpr bool operator==(const T& u) const { return base == u.base; }
+	constexpr bool operator==(const base_type& b) const { return base == b; }
+	constexpr bool operator!=(const T& u) const { return base != u.base; }
+	constexpr bool operator!=(const base_type& b) const { return base != b; }
+};
+
+/*
+	Create the UTF-16 iterator for the most common [std::u16string_view] case.
+*/
+typedef basic_utf16iterator<std::u16string_view::const_iterator> utf16iterator;
+
+namespace detail {
+	/*
+		textFormat and binaryFormat describe the two encodings of compiled finite
+		state machines supported by the compiler and matcher classes: both share
+		exactly the same sequence of "op" chars, and differ only in how operands
+		(lengths, class modifiers, "fast path" bitsets, and class members) are
+		represented following those ops.
+
+		The text form is the original "human-readable" one - lengths are base64
+		digits, bitsets are 32 hex digits, and code points are in UTF-8 - and is
+		what you probably want to be looking at while debugging... note that the
+		lengths are of variable width: a single base64 digit giving the number of
+		[big-endian] base64 digits that follow, so that "BH" is 7 while "CBj" is
+		99 - and as such, the text form has NO practical limit on lengths either.
+
+		The binary form trades that readability for speed: lengths and class code
+		points are native-width integers, and the 128-bit "fast path" bitsets are
+		stored as a pair of uint64_t words, so that a test for class membership
+		is a single shift-and-mask... with NO decoding of anything at match time.
+		Likewise, the members of "interpreted" classes are ALL stored as [sorted]
+		ranges - even single code points - so that they can be binary-searched.
+
+		N.B. - binary machines are in NATIVE byte order, so should be regarded as
+		transient artifacts of a particular process, not as an exchange format.
+	*/
+	struct textFormat
+	{
+		static constexpr char Header = '#';
+		static constexpr size_t LengthWidth = 2;	// (MINIMUM width of a length)
+		static constexpr size_t BitsetWidth = 32;
+		static constexpr bool RangesOnly = false;	// (class members: '+' OR '-')
+
+		static constexpr auto base64Digit(int n) noexcept {
+			return							// RFCs 2045/3548/4648/4880 et al
+				"ABCDEFGHIJKLMNOPQRSTUVWXYZ"//  0-25
+				"abcdefghijklmnopqrstuvwxyz"// 26-51
+				"0123456789"				// 52-61
+				"+/"						// 62-63
+				[n & 0x3f];
+		}
+		static constexpr auto hexDigit(int n) noexcept { return "0123456789abcdef"[n & 0xf]; }
+		static constexpr int base64Value(char c) noexcept {
+			return
+				"\x00\x00\x00\x00\x00\x00\x00\x00"	// 00-0f <illegal>
+				"\x00\x00\x00\x00\x00\x00\x00\x00"
+				"\x00\x00\x00\x00\x00\x00\x00\x00"	// 10-1f <illegal>
+				"\x00\x00\x00\x00\x00\x00\x00\x00"
+
+				"\x00\x00\x00\x00\x00\x00\x00\x00"	// 20-2f <illegal>,+,/
+				"\x00\x00\x00\x3e\x00\x00\x00\x3f"
+				"\x34\x35\x36\x37\x38\x39\x3a\x3b"	// 30-3f 0-9,<illegal>
+				"\x3c\x3d\x00\x00\x00\x00\x00\x00"
+
+				"\x00\x00\x01\x02\x03\x04\x05\x06"	// 40-4f <illegal>,A-O
+				"\x07\x08\x09\x0a\x0b\x0c\x0d\x0e"
+				"\x0f\x10\x11\x12\x13\x14\x15\x16"	// 50-5f P-Z,<illegal>
+				"\x17\x18\x19\x00\x00\x00\x00\x00"
+
+				"\x00\x1a\x1b\x1c\x1d\x1e\x1f\x20"	// 60-6f <illegal>,a-o
+				"\x21\x22\x23\x24\x25\x26\x27\x28"
+				"\x29\x2a\x2b\x2c\x2d\x2e\x2f\x30"	// 70-7f p-z,<illegal>
+				"\x31\x32\x33\x00\x00\x00\x00\x00"
+				[c & 0x7f];
+		}
+		static constexpr int hexValue(char c) noexcept {
+			return
+				"\x00\x00\x00\x00\x00\x00\x00\x00"	// 00-0f <illegal>
+				"\x00\x00\x00\x00\x00\x00\x00\x00"
+				"\x00\x00\x00\x00\x00\x00\x00\x00"	// 10-1f <illegal>
+				"\x00\x00\x00\x00\x00\x00\x00\x00"
+
+				"\x00\x00\x00\x00\x00\x00\x00\x00"	// 20-2f <illegal>
+				"\x00\x00\x00\x00\x00\x00\x00\x00"
+				"\x00\x01\x02\x03\x04\x05\x06\x07"	// 30-3f 0-9
+				"\x08\x09\x00\x00\x00\x00\x00\x00"	//  ...  <illegal>
+
+				"\x00\x0a\x0b\x0c\x0d\x0e\x0f\x00"	// 40-4f <illegal>,A-F
+				"\x00\x00\x00\x00\x00\x00\x00\x00"	//  ...  <illegal>
+				"\x00\x00\x00\x00\x00\x00\x00\x00"	// 50-5f <illegal>
+				"\x00\x00\x00\x00\x00\x00\x00\x00"
+
+				"\x00\x0a\x0b\x0c\x0d\x0e\x0f\x00"	// 60-6f <illegal>,a-f
+				"\x00\x00\x00\x00\x00\x00\x00\x00"	//  ...  <illegal>
+				"\x00\x00\x00\x00\x00\x00\x00\x00"	// 70-7f <illegal>
+				"\x00\x00\x00\x00\x00\x00\x00\x00"
+				[c & 0x7f];
+		}
+
+		// (encoding side, used by the compiler class)
+		static constexpr auto encodeLength(size_t n) {
+			int k = 1;
+			while (k < 6 && (n >> 6 * k) != 0)
+				k++;
+			string v(1, base64Digit(k));
+			while (k-- > 0)
+				v.push_back(base64Digit((int)(n >> 6 * k)));
+			return v;
+		}
+		static constexpr char encodeModifier(bool f) noexcept { return hexDigit(f ? 1 : 0); }
+		/*
+			encodeBitset produces the representation of a "fast path" character class.
+
+			The actual form of this data is dictated by two considerations:
+
+			1) The obvious "1 character per bit" form is just a bit too voluminous for
+			our purposes, so we use our own 32 "ASCII/hex" char string for the 128-bit
+			sets used by the "fast path" logic.
+
+			2) Additionally, it was desirable to employ a format that permits fairly
+			efficient queries of individual bits WITHOUT having to "de-serialize" the
+			entire bitset.
+		*/
+		static constexpr auto encodeBitset(const classBits& b) {
+			// output the 128-bit bitset in a 4-bits-per-ASCII/hex-character format.
+			std::array<char, BitsetWidth> v{};
+			auto x = v.begin();
+			for (auto c = 128 - 4; c >= 0; c -= 4)
+				*x++ = hexDigit(
+					(b.test((size_t)c + 0) ? 1 : 0) |
+					(b.test((size_t)c + 1) ? 2 : 0) |
+					(b.test((size_t)c + 2) ? 4 : 0) |
+					(b.test((size_t)c + 3) ? 8 : 0));
+			return v;
+		}
+		template<class CharOutput>
+		static constexpr void encodeCodePoint(char32_t c, CharOutput f) noexcept { codePointToUTF8(c, f); }
+
+		// (decoding side, used by the matcher class)
+		static constexpr size_t decodeLength(const char*& p) noexcept {
+			size_t n = 0;
+			for (auto k = base64Value(*p++); k > 0; k--)
+				n = n * 64 + base64Value(*p++);
+			return n;
+		}
+		static constexpr bool decodeModifier(const char* p) noexcept { return hexValue(*p) != 0; }
+		static constexpr bool testBitset(const char* p, size_t b) noexcept {
+			return (hexValue(p[(127 - b) >> 2]) & "\x8\4\2\1"[(127 - b) & 0b11]) != 0;
+		}
+		static constexpr classBits decodeBitset(const char* p) noexcept {
+			classBits b;
+			for (size_t i = 0; i < BitsetWidth; i++)
+				b.w[i < 16 ? 1 : 0] = b.w[i < 16 ? 1 : 0] << 4 | (std::uint64_t)hexValue(p[i]);
+			return b;
+		}
+		static constexpr char32_t decodeCodePoint(const char*& p) noexcept {
+			utf8iteratorBare u = p;
+			const auto c = *u++;
+			return p = u, c;
+		}
+	};
+
+	struct binaryFormat
+	{
+		static constexpr char Header = '$';
+		static constexpr size_t LengthWidth = sizeof(std::uint32_t);
+		static constexpr size_t BitsetWidth = 2 * sizeof(std::uint64_t);
+		static constexpr bool RangesOnly = true;	// (class members: ONLY '-')
+		static constexpr size_t RangeWidth = 1 + 2 * sizeof(char32_t);
+
+		// (encoding side, used by the compiler class)
+		static constexpr auto encodeLength(size_t n) noexcept {
+			return std::bit_cast<std::array<char, LengthWidth>>((std::uint32_t)n);
+		}
+		static constexpr char encodeModifier(bool f) noexcept { return f ? 1 : 0; }
+		static constexpr auto encodeBitset(const classBits& b) {
+			return std::bit_cast<std::array<char, BitsetWidth>>(std::array<std::uint64_t, 2>{ b.w[0], b.w[1] });
+		}
+		template<class CharOutput>
+		static constexpr void encodeCodePoint(char32_t c, CharOutput f) noexcept {
+			for (const auto x : std::bit_cast<std::array<char, sizeof c>>(c))
+				f(x);
+		}
+
+		// (decoding side, used by the matcher class)
+		template<typename T>
+		static T load(const char* p) noexcept { T v; std::memcpy(&v, p, sizeof v); return v; }
+		static size_t decodeLength(const char*& p) noexcept {
+			const auto n = load<std::uint32_t>(p);
+			return p += sizeof n, n;
+		}
+		static constexpr bool decodeModifier(const char* p) noexcept { return *p != 0; }
+		static bool testBitset(const char* p, size_t b) noexcept {
+			return (load<std::uint64_t>(p + (b >> 6) * sizeof(std::uint64_t)) >> (b & 63) & 1) != 0;
+		}
+		static classBits decodeBitset(const char* p) noexcept {
+			return { { load<std::uint64_t>(p), load<std::uint64_t>(p + sizeof(std::uint64_t)) } };
+		}
+		static char32_t decodeCodePoint(const char*& p) noexcept {
+			const auto c = load<char32_t>(p);
+			return p += sizeof c, c;
+		}
+	};
+
+	/*
+		machineHeader describes the header that starts every machine, in either
+		Format: the header op, then the length of the ops that follow the header,
+		then the minimum and maximum lengths (in BYTEs) of any target that could
+		match - where a maximum of 0 is stored for "none", i.e., a '*' pattern.
+
+		N.B. - the ops end where the class table (if any) begins.
+	*/
+	struct machineHeader
+	{
+		const char* first = nullptr;	// (the ops, following the header...)
+		const char* last = nullptr;		// (... up to the class table)
+		size_t least = 0, most = 0;		// (target length bounds, in BYTEs)
+	};
+	template<class Format>
+	constexpr machineHeader decodeHeader(const char* m) {
+		auto p = m + 1;
+		const auto n = Format::decodeLength(p);
+		const auto least = Format::decodeLength(p), most = Format::decodeLength(p);
+		return { p, p + n, least, most != 0 ? most : string::npos };
+	}
+}
+
+/*
+	The compiler class is composed of a primary function - compile - which takes
+	a "pattern" specification in the style of the "glob" patterns of Unix/Linux,
+	and machine, a "payload" function that returns the now-compiled pattern for
+	subsequent display or execution by the matcher class.
+
+	It is really an alias for basic_compiler with the standard allocator, which
+	allows compiling the machine into any other [char] Allocator instead - e.g.,
+	pmr::compiler, which places it in a std::pmr::memory_resource (so that MANY
+	machines can be compiled into one "arena", and then freed all at once).
+
+	All text is expected to be in UTF-8 representation, which is usable and at
+	least minimally supported by modern C++ compilers... without attempting to
+	be a tutorial on the UTF-8 Unicode encoding, we can observe the following:
+
+	* Unicode is a set of over a million characters ("everything"), and UTF-8
+	is a way of representing Unicode "code points" as 1, 2, 3, or 4 bytes
+
+	* 7-bit ASCII is the first 128 characters of Unicode, and appears unchanged
+	in UTF-8... another way to say this is that ASCII chars ARE UTF-8 chars
+
+	* 2nd, 3rd, or 4th chars in Unicode code points will NEVER look like an
+	ASCII char, so one can still perform "normal" text comparisons or even
+	make use of the standard C++ library with UTF-8 text
+
+	* if you want to include non-ASCII text literals in C++ source, you have
+	the choice of doing it the hard way with hex/binary escaped sequences in
+	strings, \unnnn sequences in strings for 2/3-byte code points, \Unnnnnnnn
+	sequences in strings for 3-byte or 4-byte code points, or [easiest] using
+	the new UTF-8 string literals: u8"This is a UTF-8 string!"
+
+	* to see FAR more detail on this, visit http://utf8everywhere.org/
 
 	Patterns supported by the rglob::compiler and rglob::matcher classes are
 	made up of combinations of the following elements:
@@ -379,55 +1375,228 @@ typedef basic_utf8iterator<const char*> utf8iteratorBare;
 		-	use as the LAST char
 		!	use as anything BUT the first char
 		^	use as anything BUT the first char
+
+	The machine compile produces is already "optimized" as it is emitted: runs
+	of '*' (and '?') are merged, so "a**?*b" compiles the same as "a?*b", a run
+	of several '?' becomes a single op that skips that many code points, and a
+	character class with only ONE member (e.g., "[a]") is fused with any exact
+	match sequences around it into one longer one.
 */
-class compiler
+template<class Allocator = std::allocator<char>>
+class basic_compiler
 {
-	string fsm;							// compiled fsm for current glob pattern
+	using string_type = std::basic_string<char, std::char_traits<char>, Allocator>;
+	using pair_type = std::pair<size_t, size_t>;
+
+	string_type fsm;					// compiled fsm for current glob pattern
+	string_type classes;				// (class table, while compiling)
+	string_type pending;				// (exact match text, NOT yet emitted)
+	size_t least = 0, most = 0;			// (target length bounds, while compiling)
+	bool folding = false;				// (ignore_case, while compiling)
+	std::vector<pair_type, typename std::allocator_traits<Allocator>::template rebind_alloc<pair_type>> interned;// (its classes: at, size)
 
-	static constexpr auto base64Digit(int n) noexcept {
-		return							// RFCs 2045/3548/4648/4880 et al
-			"ABCDEFGHIJKLMNOPQRSTUVWXYZ"//  0-25
-			"abcdefghijklmnopqrstuvwxyz"// 26-51
-			"0123456789"				// 52-61
-			"+/"						// 62-63
-			[n & 0x3f];
-	}
-	static constexpr auto hexDigit(int n) noexcept { return "0123456789abcdef"[n & 0xf]; }
 	constexpr void emit(char c) { fsm.push_back(c); }
 	constexpr void emit(string_view v) { fsm.append(v); }
 	constexpr void emitAt(size_t i, char c) { fsm[i] = c; }
 	/*
 		emitPackedBitset inserts a representation of the just-processed "fast path"
-		character class into the current finite state machine definition.
-
-		The actual form of this data is dictated by two considerations:
-
-		1) The stdlib bitset implementation only has convenient "[de-]serialization"
-		options for up-to 64-element sets - the "1 character per bit" form is just a
-		bit too voluminous for our purposes, so we use our own 32 "ASCII/hex" char
-		string for the 128-bit sets used by the "fast path" logic.
-
-		2) Additionally, it was desirable to employ a format that permits fairly
-		efficient queries of individual bits WITHOUT having to "de-serialize" the
-		entire bitset.
+		character class into the current finite state machine definition, in the
+		form dictated by the Format in use (see detail::textFormat::encodeBitset).
 	*/
-	constexpr void emitPackedBitset(const std::bitset<128>& b) {
-		// output the 128-bit bitset in a 4-bits-per-ASCII/hex-character format.
-		for (auto c = 128 - 4; c >= 0; c -= 4)
-			emit(hexDigit(
-				(b.test((size_t)c + 0) ? 1 : 0) |
-				(b.test((size_t)c + 1) ? 2 : 0) |
-				(b.test((size_t)c + 2) ? 4 : 0) |
-				(b.test((size_t)c + 3) ? 8 : 0)));
+	template<class Format>
+	constexpr void emitPackedBitset(const detail::classBits& b) {
+		for (const auto x : Format::encodeBitset(b))
+			emit(x);
 	}
+	// (N.B. - the "padding" emitted for a length MAY be widened by this)
+	template<class Format>
 	constexpr void emitLengthAt(size_t i, size_t n) {
-		emitAt(i + 0, base64Digit((n & 0xfc) >> 6)), emitAt(i + 1, base64Digit((n & 0x3f)));
+		const auto v = Format::encodeLength(n);
+		fsm.replace(i, Format::LengthWidth, v.data(), v.size());
 	}
-	constexpr void emitPadding(int n, char c = '_') { while (n-- > 0) emit(c); }
+	constexpr void emitPadding(size_t n, char c = '_') { while (n-- > 0) emit(c); }
 	constexpr auto emitted() const noexcept { return fsm.size(); }
-	constexpr void emitUTF8CodePoint(char32_t c) { detail::codePointToUTF8(c, [this](char x) { emit(x); }); }
+	template<class Format>
+	constexpr void emitCodePoint(char32_t c) { Format::encodeCodePoint(c, [this](char x) { emit(x); }); }
+	/*
+		emitLiteral adds to the "exact match" text that is pending, which is only
+		emitted [as a single '=' op] by flushLiteral - before the next op, or at
+		the end of the machine - so that adjacent sources of exact match text in
+		the pattern (e.g., "ab[c]d") are "fused" into one longer literal.
+	*/
+	constexpr void emitLiteral(string_view v) { pending.append(v); }
+	template<class Format>
+	constexpr void flushLiteral() {
+		if (pending.empty())
+			return;
+		if (!folding)
+			emitExact<Format>('=', pending);
+		else {
+			// (with ignore_case, ASCII text is emitted folded - as a '~' op, which
+			// is compared ignoring ASCII case, IFF it has letters - while any other
+			// letters become classes of BOTH of their cases, see foldCase)
+			string run;
+			auto letters = false;
+			auto emitRun = [&] {
+				if (!run.empty())
+					emitExact<Format>(letters ? '~' : '=', run), run.clear(), letters = false;
+			};
+			for (utf8iteratorBare u = pending.data(), e = u + pending.size(); u != e; ++u)
+				if (const auto c = *u; isascii(c))
+					run.push_back(detail::foldASCII((char)c)), letters |= (c | 0x20) >= 'a' && (c | 0x20) <= 'z';
+				else if (auto m = foldCase({ { c, c } }); m.size() > 1)
+					emitRun(), emitRanges<Format>(normalizeClass(std::move(m), false));
+				else
+					detail::codePointToUTF8(c, [&](char x) { run.push_back(x); });
+			emitRun();
+		}
+		pending.clear();
+	}
+	template<class Format>
+	constexpr void emitExact(char op, string_view v) {
+		const auto n = Format::encodeLength(v.size());
+		emit(op), emit(string_view(n.data(), n.size())), emit(v), consumes(v.size(), v.size());
+	}
+	/*
+		consumes accounts for an op (or ops) that will consume at least lo and at
+		most hi BYTEs of any target, for the bounds recorded in the header - where
+		a hi of npos means "any number of" (and so makes the maximum unbounded).
+	*/
+	constexpr void consumes(size_t lo, size_t hi) noexcept {
+		least += lo;
+		if (most != string::npos)
+			most = hi != string::npos && hi <= AllowedMaxFSM - most ? most + hi : string::npos;
+	}
+	/*
+		emitWildcards emits the ops for a run of '?' and '*' metachars, of which
+		n were '?': since ANY such run matches exactly the same targets as the
+		same number of '?' followed by [at most] a single '*', that is what gets
+		emitted - with a run of '?' as a single '.' op, which skips n code points.
+	*/
+	template<class Format>
+	constexpr void emitWildcards(size_t n, bool star) {
+		flushLiteral<Format>();
+		if (n == 1)
+			emit('?');
+		else if (n > 1) {
+			const auto v = Format::encodeLength(n);
+			emit('.'), emit(string_view(v.data(), v.size()));
+		}
+		consumes(n, n <= AllowedMaxFSM / 4 ? 4 * n : string::npos);
+		if (star)
+			emit('*'), consumes(0, string::npos);
+	}
+	/*
+		internClass moves the [complete] character class just emitted at pos out
+		to the class table - unless an identical class is ALREADY there - leaving
+		in its place just its op followed by the position of its body within the
+		table (as a length)... so that repeated classes cost only THAT much.
+	*/
+	template<class Format>
+	constexpr void internClass(size_t pos) {
+		const string_type body(string_view(fsm).substr(pos), fsm.get_allocator());
+		fsm.resize(pos);
+		auto at = classes.size();
+		for (const auto& [o, n] : interned)
+			if (n == body.size() && string_view(classes).substr(o, n) == body) {
+				at = o;
+				break;
+			}
+		if (at == classes.size())
+			interned.emplace_back(at, body.size()), classes.append(body);
+		const auto v = Format::encodeLength(at);
+		emit(body.front()), emit(string_view(v.data(), v.size()));
+	}
 	constexpr auto peek(string_view::const_iterator i) const { return *++i; }
-	auto peek(utf8iterator u) const { return *++u; }
+	constexpr auto peek(utf8iterator u) const { return *++u; }
+
+	/*
+		normalizeClass turns the [single char and range] members of a "general case"
+		character class - in the order they were written - into the fewest sorted,
+		disjoint, and non-adjacent ranges with the same meaning... "folding" in any
+		inversion of the class by taking their complement (over all the code points
+		that UTF-8 can represent), so that membership of a code point in the class
+		is simply whether it falls in one of the ranges.
+	*/
+	static constexpr auto normalizeClass(std::vector<std::pair<char32_t, char32_t>> v, bool invert) {
+		// (discard "backwards" ranges - which can never match anything - then sort)
+		v.erase(std::remove_if(v.begin(), v.end(), [](const auto& r) { return r.first > r.second; }), v.end());
+		std::sort(v.begin(), v.end());
+		std::vector<std::pair<char32_t, char32_t>> m;
+		for (const auto& r : v)
+			if (!m.empty() && r.first <= m.back().second + 1)
+				m.back().second = std::max(m.back().second, r.second);
+			else
+				m.push_back(r);
+		if (!invert)
+			return m;
+		std::vector<std::pair<char32_t, char32_t>> c;
+		char32_t next = 0;
+		for (const auto& r : m) {
+			if (r.first > next)
+				c.emplace_back(next, r.first - 1);
+			next = r.second + 1;
+		}
+		if (next <= detail::MaxCodePoint)
+			c.emplace_back(next, detail::MaxCodePoint);
+		return c;
+	}
+
+	/*
+		foldCase adds the other case of each letter among the members of a "general
+		case" character class (per detail::caseRanges) as another member - which
+		is done BEFORE normalizeClass, so that any inversion of the class applies
+		to the letters of both cases.
+	*/
+	static constexpr auto foldCase(std::vector<std::pair<char32_t, char32_t>> v) {
+		for (size_t i = 0, n = v.size(); i < n; i++) {
+			const auto [first, last] = v[i];
+			for (const auto& r : detail::caseRanges)
+				if (const auto lo = std::max(first, r.first), hi = std::min(last, r.last); lo > hi)
+					continue;
+				else if (r.delta != 0)
+					v.emplace_back(lo + r.delta, hi + r.delta);
+				else
+					// (alternating pairs: upper case at even offsets, lower at odd)
+					for (auto c = lo; c <= hi; c++) {
+						const auto d = ((c - r.first) & 1) != 0 ? c - 1 : c + 1;
+						v.emplace_back(d, d);
+					}
+		}
+		return v;
+	}
+
+	/*
+		emitRanges emits a "general case" character class with the [normalized]
+		members m, and interns it (see internClass).
+	*/
+	template<class Format>
+	constexpr void emitRanges(const std::vector<std::pair<char32_t, char32_t>>& m) {
+		// (members are sorted, so the first and last give the bounds)
+		auto w = [](char32_t c) { size_t k = 0; detail::codePointToUTF8(c, [&](char) { k++; }); return k; };
+		if (!m.empty())
+			consumes(w(m.front().first), w(m.back().second));
+		const auto pos = emitted();
+		emit('[');
+		// (N.B. - any inversion is "folded" into the members, see normalizeClass)
+		emit(Format::encodeModifier(false));
+		// initialize and "remember" location of length (to be filled in later)
+		const auto lenPos = emitted();
+		emitPadding(Format::LengthWidth);
+		// output the members as [normalized] match-time operators
+		for (const auto& [c1, c2] : m)
+			if (c1 == c2 && !Format::RangesOnly)
+				// (generate "single char" matching operator)
+				emit('+'), emitCodePoint<Format>(c1);
+			else
+				// (generate "char range" matching operator)
+				emit('-'), emitCodePoint<Format>(c1), emitCodePoint<Format>(c2);
+		// finish up by generating the "NO match" operator...
+		emit(']');
+		// ... and output the length of the character class "interpreter" logic
+		emitLengthAt<Format>(lenPos, emitted() - pos - (1 + 1 + Format::LengthWidth + 1));
+		internClass<Format>(pos);
+	}
 
 	/*
 		compileClass processes a single "character class" string from a glob pattern
@@ -442,14 +1611,18 @@ class compiler
 
 		In the general [non-ASCII] case, the match-time evaluation of matches in the
 		character class will be done by evaluating a number of either single-char or
-		char-range expressions serially... if at least one matches the "target"/test
-		char, then the class is matched - otherwise, the class match fails.
+		char-range expressions - sorted and merged by normalizeClass, so that these
+		can be searched rather than tried serially... if one matches the "target"/
+		test char, then the class is matched - otherwise, the class match fails.
+
+		Either way, the class body is then interned (see internClass), so that the
+		finite state machine itself only ever contains a reference to it.
 
 		The number of chars/BYTEs consumed is returned.
 	*/
-	auto compileClass(string_view pattern, string_view::const_iterator p) {
+	template<class Format>
+	constexpr auto compileClass(string_view pattern, string_view::const_iterator p) {
 		const auto base = p++;
-		const auto pos = emitted();
 		// check for "inversion" of character class metacharacter
 		auto invert = false;
 		if (*p == '!' || *p == '^')
@@ -466,50 +1639,65 @@ class compiler
 			throw std::invalid_argument(string("Missing terminating ']' for character class @ ") + string(pattern.substr(base - pattern.cbegin())));
 		if (std::all_of(p, p + (close - o), [](char c) { return isascii(c); })) {
 			// the character class is ALL ASCII chars, so we can use the "fast path"
-			emit('{');
 			// (neither "invert" flag nor "length" field are needed for "fast path")
-			std::bitset<128> b;
-			// "fast path" (bitset) invert is easy
-			if (invert)
-				b.set();
+			detail::classBits b;
 			if (leadingCloseBracket)
-				b.flip(']');
-			// process all class members by "flipping" corresponding bits...
+				b.set(']');
+			// process all class members by setting corresponding bits...
 			while (*p != ']')
 				if (const auto c1 = *p++, c2 = *p; c2 == '-' && peek(p) != ']') {
 					const auto c3 = *++p;
-					for (auto c = c1; c <= c3; c++)
-						b.flip(c);
+					for (int c = c1; c <= c3; c++)
+						b.set(c);
 					++p;
 				} else
-					b.flip(c1);
+					b.set(c1);
+			// (for ignore_case, letters are members in BOTH cases...)
+			if (folding)
+				for (int c = 'A'; c <= 'Z'; c++)
+					if (b.test(c) || b.test(c | 0x20))
+						b.set(c), b.set(c | 0x20);
+			// ("fast path" (bitset) invert is easy)
+			if (invert)
+				b.flip();
+			++p;
+			// (a class of ONE member - or for ignore_case, of ONE letter in both
+			// cases - is really just exact match text)
+			if (const auto n = b.count(); n == 1 || (folding && n == 2 && b.first() >= 'A' && b.first() <= 'Z' && b.test(b.first() | 0x20)))
+				return emitLiteral(string(1, (char)b.first())), p - base;
 			// ... finish up by copying the [packed] bitset to finite state machine
-			emitPackedBitset(b), ++p;
+			flushLiteral<Format>();
+			const auto pos = emitted();
+			emit('{'), emitPackedBitset<Format>(b), consumes(1, 1);
+			internClass<Format>(pos);
 			return p - base;
 		} else {
 			// "general case" character class, output single and range match exprs
-			emit('[');
-			emit(hexDigit(invert ? 1 : 0));
-			// initialize and "remember" location of length (to be filled in later)
-			const auto lenPos = emitted();
-			emitPadding(LengthSize);
+			std::vector<std::pair<char32_t, char32_t>> v;
 			if (leadingCloseBracket)
-				emit('+'), emit(']');
+				v.emplace_back(']', ']');
 			// NOW switch to full UTF-8 (Unicode) processing...
 			utf8iterator u = p;
-			// ... and process all class members by outputting match-time operators
+			// ... and collect all class members as ranges...
 			while (*u != ']')
 				if (const auto c1 = *u++, c2 = *u; c2 == '-' && peek(u) != ']') {
-					// (generate "char range" matching operator)
 					const auto c3 = *++u;
-					emit('-'), emitUTF8CodePoint(c1), emitUTF8CodePoint(c3), ++u;
+					v.emplace_back(c1, c3), ++u;
 				} else
-					// (generate "single char" matching operator)
-					emit('+'), emitUTF8CodePoint(c1);
-			// finish up by generating the "NO match" operator...
-			emit(']'), ++u;
-			// ... and output the length of the character class "interpreter" logic
-			emitLengthAt(lenPos, emitted() - pos - (1 + 1 + LengthSize + 1));
+					v.emplace_back(c1, c1);
+			++u;
+			// ... to be normalized (after adding the other cases, for ignore_case)
+			if (folding)
+				v = foldCase(std::move(v));
+			const auto m = normalizeClass(std::move(v), invert);
+			// (a class of ONE member is really just exact match text)
+			if (m.size() == 1 && m.front().first == m.front().second) {
+				string x;
+				detail::codePointToUTF8(m.front().first, [&](char c) { x.push_back(c); });
+				return emitLiteral(x), u - base;
+			}
+			flushLiteral<Format>();
+			emitRanges<Format>(m);
 			return u - base;
 		}
 	}
@@ -520,27 +1708,71 @@ class compiler
 
 		The number of chars/BYTEs consumed is returned.
 	*/
-	auto compileString(string_view pattern, string_view::const_iterator p) {
-		emit('=');
-		// initialize and "remember" location of length (to be filled in later)
-		const auto lenPos = emitted();
-		emitPadding(LengthSize);
+	template<class Format>
+	constexpr auto compileString(string_view pattern, string_view::const_iterator p) {
 		// determine length...
 		const auto o = p - pattern.cbegin();
 		const auto i = pattern.find_first_of("?*[", o);
 		const auto n = i != string::npos ? i - o : pattern.size() - o;
-		// ... and copy "exact match" string to finite state machine
-		emit(pattern.substr(p - pattern.cbegin(), n));
-		emitLengthAt(lenPos, n);
+		// ... and add "exact match" string to the [pending] literal
+		emitLiteral(pattern.substr(o, n));
 		return n;
 	}
+	/*
+		compileWith performs the actual work of compile (below), generating the
+		finite state machine in the specified Format.
+	*/
+	template<class Format>
+	constexpr void compileWith(string_view pattern) {
+		fsm.clear(), classes.clear(), pending.clear(), interned.clear();
+		least = most = 0;
+		// prep for filling in compiled length and bounds of pattern later
+		emit(Format::Header), emitPadding(3 * Format::LengthWidth);
+		ptrdiff_t incr = 1;
+		// iterate over, compile, and consume pattern elements
+		for (auto pi = pattern.cbegin(); pi != pattern.cend(); pi += incr) {
+			switch (*pi) {
+			case '?':
+			case '*': {
+				// (a run of wildcards is compiled as a whole, see emitWildcards)
+				const auto i = pattern.find_first_not_of("?*", pi - pattern.cbegin());
+				const auto run = pattern.substr(pi - pattern.cbegin(), i != string::npos ? i - (pi - pattern.cbegin()) : string::npos);
+				const auto n = (size_t)std::count(run.cbegin(), run.cend(), '?');
+				emitWildcards<Format>(n, n < run.size()), incr = run.size();
+				break;
+			}
+			case '[':
+				incr = compileClass<Format>(pattern, pi);
+				break;
+			default:
+				incr = compileString<Format>(pattern, pi);
+			}
+			if (emitted() + pending.size() + classes.size() > AllowedMaxFSM)
+				throw std::length_error(string("Exceeded allowed compiled pattern size @ ") + string(pattern.substr(pi - pattern.cbegin())));
+		}
+		flushLiteral<Format>();
+		// NOW fill in length and bounds of compiled pattern [back to front, since
+		// each may widen its padding]... IFF there is any actual pattern
+		if (const auto n = emitted(); n > 1 + 3 * Format::LengthWidth) {
+			emitLengthAt<Format>(1 + 2 * Format::LengthWidth, most != string::npos ? most : 0);
+			emitLengthAt<Format>(1 + Format::LengthWidth, least);
+			emitLengthAt<Format>(1, n - (1 + 3 * Format::LengthWidth));
+		} else
+			fsm.clear();
+		// ... followed by the class table (which is NOT included in that length)
+		emit(classes);
+		classes.clear(), interned.clear();
+		if (emitted() > AllowedMaxFSM)
+			throw std::length_error("Exceeded allowed compiled pattern size.");
+	}
 
 public:
-	compiler() {
-		// N.B. - it is IMPORTANT to do this in the constructor!
-		// (needed when composed with the matcher class in rglob::glob class)
-		fsm.reserve(AllowedMaxFSM);
-	}
+	using allocator_type = Allocator;
+
+	constexpr basic_compiler() = default;
+	constexpr explicit basic_compiler(const Allocator& a) : fsm(a), classes(a), pending(a), interned(a) {}
+
+	constexpr allocator_type get_allocator() const noexcept { return fsm.get_allocator(); }
 
 	/*
 		compile accepts a pattern following the rules detailed in the class
@@ -548,330 +1780,2772 @@ public:
 		subsequent matching: a "finite state machine" able to recognize text
 		matching the supplied [UTF-8] pattern.
 
+		By default, the machine is generated in the "human-readable" text form;
+		specifying the binary option instead yields a machine that is faster to
+		execute (see detail::textFormat and detail::binaryFormat for details).
+
+		Specifying the ignore_case option yields a machine that matches letters
+		in EITHER case, at NO extra cost when matching: the other cases are added
+		to character classes as they are compiled, and exact match text has its
+		ASCII letters compared ignoring case (by a '~' op) - while other letters
+		become classes of both of their cases (see detail::caseRanges).
+
 		invalid_argument if the pattern string is NOT valid UTF-8
 
 		invalid_argument if pattern string has an unterminated character class
 
-		length_error if the compiled pattern is > 4 KB (implementation limit)
+		length_error if the compiled pattern is > 4 GB (implementation limit)
 
 		In all cases, an explanatory text message is included, with position
-		information if applicable.
+		information if applicable... AND the previously compiled machine (if
+		there was one) is left undisturbed.
+
+		N.B. - a successful compile replaces the machine, so any string_view of
+		the previous one obtained from machine() is NO longer valid after this!
 	*/
-	void compile(string_view pattern) {
+	constexpr void compile(string_view pattern, unsigned opts = defaults) {
 		// make SURE pattern is *structurally* valid UTF8
 		if (!detail::validateUTF8String(pattern))
 			throw std::invalid_argument("Pattern string is not valid UTF-8.");
-		fsm.clear();
-		// prep for filling in compiled length of pattern later
-		emit('#'), emitPadding(2);
-		ptrdiff_t incr = 1;
-		// iterate over, compile, and consume pattern elements
-		for (auto pi = pattern.cbegin(); pi != pattern.cend(); pi += incr) {
-			switch (*pi) {
-			case '?':
-				emit(*pi), incr = 1;
-				break;
-			case '*':
-				emit(*pi), incr = 1;
-				break;
-			case '[':
-				incr = compileClass(pattern, pi);
-				break;
-			default:
-				incr = compileString(pattern, pi);
-			}
-			if (emitted() > AllowedMaxFSM)
-				throw std::length_error(string("Exceeded allowed compiled pattern size @ ") + string(pattern.substr(pi - pattern.cbegin())));
+		// (N.B. - swapping is only well-defined with EQUAL allocators, like these)
+		string_type previous(fsm.get_allocator());
+		previous.swap(fsm);
+		folding = (opts & ignore_case) != 0;
+		try {
+			if (opts & binary)
+				compileWith<detail::binaryFormat>(pattern);
+			else
+				compileWith<detail::textFormat>(pattern);
+		} catch (...) {
+			fsm.swap(previous);
+			throw;
 		}
-		// NOW fill in length of compiled pattern... IFF there is any actual pattern
-		if (const auto n = emitted(); n > 1 + LengthSize)
-			emitLengthAt(1, n - (1 + LengthSize));
-		else
-			fsm.clear();
+		// (machines are sized exactly, as there may be LOTS of them)
+		fsm.shrink_to_fit();
 	}
 
 	/*
 		machine returns the compiled form of the [valid] glob pattern supplied
-		to compile... note that while this is "human-readable", the matcher
-		class's pretty_print does a better job of displaying this information.
+		to compile... note that while this is "human-readable" (at least if the
+		binary option was NOT used), the matcher class's pretty_print does a
+		better job of displaying this information.
 	*/
-	string_view machine() const noexcept { return fsm; }
+	constexpr string_view machine() const noexcept { return fsm; }
+};
+
+using compiler = basic_compiler<>;
+
+/*
+	A match_stats accumulates counts of the work done by any number of calls of
+	the [instrumented] matcher::match overloads that accept one: the number of
+	executions of each op (indexed by the op char, e.g., ops['=']), including the
+	members ('+' or '-') of "interpreted" classes that were tested, bytes of the
+	target scanned while searching for a segment after a '*', and the number of
+	times such a segment had to be retried.
+
+	Per-op counts are ALSO kept by the op's offset in the machine - as shown by
+	matcher::pretty_print - both for executions (at) and for the op that was the
+	last executed before a target was rejected (rejected_at)... which identifies
+	the "expensive" parts of a pattern.
+
+	N.B. - the un-instrumented overloads of match do none of this work at all.
+*/
+struct match_stats
+{
+	size_t targets = 0;					// targets matched against
+	size_t matched = 0;					// ... that matched
+	size_t prefiltered = 0;				// ... rejected before running the machine
+	size_t floating = 0;				// bytes scanned searching after a '*'
+	size_t retries = 0;					// segments retried after a '*'
+	std::array<size_t, 128> ops{};		// executions, by op
+	std::vector<size_t> at;				// executions, by machine offset
+	std::vector<size_t> rejected_at;	// rejections, by machine offset
+};
+
+/*
+	A match_span locates [by BYTE offset and length] the text of a target that
+	was consumed by one RUN of wildcards in the pattern - i.e., by any sequence
+	of consecutive '?' and '*' metachars, which is compiled as a unit (so that,
+	e.g., "*?" and "?*" consume the same text, as ONE span).
+
+	The spans are numbered in pattern order, from zero, so that matching "*-app-
+	*.gz" against "2024-app-07.gz" yields the spans of "2024" and "07" (see
+	matcher::match).
+*/
+struct match_span
+{
+	size_t offset = 0;					// first BYTE consumed
+	size_t length = 0;					// ... and how many
 };
 
+namespace detail {
+	/*
+		noProbe, statsProbe, and captureProbe are the "probes" with which matcher::
+		matchWith is instantiated: it calls op before executing each op (including
+		the members tested in classes), floating for each search after a '*', retry
+		for each retried segment, and reject when the target fails to match... as
+		well as skip for the text consumed by each '?' (or '.'), star at each '*',
+		and anchor where the text consumed by the most recent '*' ends.
+
+		All of the functions of noProbe are empty, so that once inlined, there is
+		NOTHING left of them... i.e., instrumentation costs nothing when unused.
+	*/
+	struct noProbe
+	{
+		constexpr void op(const char*) const noexcept {}
+		constexpr void floating(size_t) const noexcept {}
+		constexpr void retry() const noexcept {}
+		constexpr void reject() const noexcept {}
+		constexpr void skip(size_t, size_t) const noexcept {}
+		constexpr void star(size_t) const noexcept {}
+		constexpr void anchor(size_t) const noexcept {}
+	};
+
+	struct statsProbe
+	{
+		match_stats& s;
+		const char* base;				// (start of the machine)
+		const char* last = nullptr;		// (most recently executed op)
+
+		static void count(std::vector<size_t>& v, size_t i) { if (i >= v.size()) v.resize(i + 1); v[i]++; }
+
+		void op(const char* mi) { s.ops[*mi & 0x7f]++, count(s.at, mi - base), last = mi; }
+		void floating(size_t n) noexcept { s.floating += n; }
+		void retry() noexcept { s.retries++; }
+		void reject() { if (last != nullptr) count(s.rejected_at, last - base); }
+		constexpr void skip(size_t, size_t) const noexcept {}
+		constexpr void star(size_t) const noexcept {}
+		constexpr void anchor(size_t) const noexcept {}
+	};
+
+	/*
+		captureProbe records the match_spans of the wildcard runs into s (as many
+		as it can hold): a '*' directly following the text skipped by a '?' is of
+		the SAME run (as no other op can consume zero BYTEs), and a retry starts
+		over with the run after that of the most recent '*'.
+	*/
+	struct captureProbe
+	{
+		std::span<match_span> s;
+		size_t k = 0;					// (run to be recorded next)
+		size_t run = 0;					// (run of the most recent '*')
+		size_t end = string::npos;		// (where the most recent '?' ended)
+
+		void put(size_t o, size_t n) noexcept { if (k < s.size()) s[k] = { o, n }; k++; }
+
+		constexpr void op(const char*) const noexcept {}
+		constexpr void floating(size_t) const noexcept {}
+		void retry() noexcept { k = run + 1, end = string::npos; }
+		constexpr void reject() const noexcept {}
+		void skip(size_t o, size_t e) noexcept { put(o, e - o), end = e; }
+		void star(size_t o) noexcept {
+			if (o == end)
+				run = k - 1;
+			else
+				run = k, put(o, 0);
+			end = string::npos;
+		}
+		void anchor(size_t o) noexcept { if (run < s.size()) s[run].length = o - s[run].offset; }
+	};
+}
+
 /*
 	The matcher class accepts (via its constructor) the compiled representation
 	of a "glob" pattern from the compiler class above, and can then be used to
 	match targets against this pattern with its match function, or to output it
 	in "pretty-printed" form to a supplied stream with pretty_print.
+
+	Machines in either the text or binary forms are accepted, and recognized by
+	their leading "header" op.
+
+	N.B. - a matcher is never modified by matching (or by any other of its const
+	member functions), so a single matcher may be used by any number of threads
+	concurrently - e.g., by parallel_filter (below).
 */
 class matcher
 {
 	string_view fsm;					// compiled fsm for current glob pattern
+	string_view head, tail;				// literals the target MUST start / end with
+	string_view longest;				// longest literal the target MUST contain
+	string_view required;				// (... if worth searching for up front)
+	size_t shortest = 0, widest = 0;	// target length bounds (in BYTEs)
 
-	static constexpr int base64Value(char c) noexcept {
-		return
-			"\x00\x00\x00\x00\x00\x00\x00\x00"	// 00-0f <illegal>
-			"\x00\x00\x00\x00\x00\x00\x00\x00"
-			"\x00\x00\x00\x00\x00\x00\x00\x00"	// 10-1f <illegal>
-			"\x00\x00\x00\x00\x00\x00\x00\x00"
-
-			"\x00\x00\x00\x00\x00\x00\x00\x00"	// 20-2f <illegal>,+,/
-			"\x00\x00\x00\x3e\x00\x00\x00\x3f"
-			"\x34\x35\x36\x37\x38\x39\x3a\x3b"	// 30-3f 0-9,<illegal>
-			"\x3c\x3d\x00\x00\x00\x00\x00\x00"
-
-			"\x00\x00\x01\x02\x03\x04\x05\x06"	// 40-4f <illegal>,A-O
-			"\x07\x08\x09\x0a\x0b\x0c\x0d\x0e"
-			"\x0f\x10\x11\x12\x13\x14\x15\x16"	// 50-5f P-Z,<illegal>
-			"\x17\x18\x19\x00\x00\x00\x00\x00"
-
-			"\x00\x1a\x1b\x1c\x1d\x1e\x1f\x20"	// 60-6f <illegal>,a-o
-			"\x21\x22\x23\x24\x25\x26\x27\x28"
-			"\x29\x2a\x2b\x2c\x2d\x2e\x2f\x30"	// 70-7f p-z,<illegal>
-			"\x31\x32\x33\x00\x00\x00\x00\x00"
-			[c & 0x7f];
-	}
-	static constexpr int hexValue(char c) noexcept {
-		return
-			"\x00\x00\x00\x00\x00\x00\x00\x00"	// 00-0f <illegal>
-			"\x00\x00\x00\x00\x00\x00\x00\x00"
-			"\x00\x00\x00\x00\x00\x00\x00\x00"	// 10-1f <illegal>
-			"\x00\x00\x00\x00\x00\x00\x00\x00"
-
-			"\x00\x00\x00\x00\x00\x00\x00\x00"	// 20-2f <illegal>
-			"\x00\x00\x00\x00\x00\x00\x00\x00"
-			"\x00\x01\x02\x03\x04\x05\x06\x07"	// 30-3f 0-9
-			"\x08\x09\x00\x00\x00\x00\x00\x00"	//  ...  <illegal>
-
-			"\x00\x0a\x0b\x0c\x0d\x0e\x0f\x00"	// 40-4f <illegal>,A-F
-			"\x00\x00\x00\x00\x00\x00\x00\x00"	//  ...  <illegal>
-			"\x00\x00\x00\x00\x00\x00\x00\x00"	// 50-5f <illegal>
-			"\x00\x00\x00\x00\x00\x00\x00\x00"
-
-			"\x00\x0a\x0b\x0c\x0d\x0e\x0f\x00"	// 60-6f <illegal>,a-f
-			"\x00\x00\x00\x00\x00\x00\x00\x00"	//  ...  <illegal>
-			"\x00\x00\x00\x00\x00\x00\x00\x00"	// 70-7f <illegal>
-			"\x00\x00\x00\x00\x00\x00\x00\x00"
-			[c & 0x7f];
-	}
-	auto opAt(utf8iteratorBare i) const { return *(utf8iteratorBare::base_type)i; }
-	auto decodeLengthAt(utf8iteratorBare i) const { return base64Value(opAt(i + 0)) * 64 + base64Value(opAt(i + 1)); }
-	auto decodeModifierAt(utf8iteratorBare i) const { return hexValue(opAt(i)); }
-	constexpr int packedBitsetMask(int b) const noexcept { return "\x8\4\2\1"[(127 - b) & 0b11]; }
-	auto packedBitsetNibbleAt(utf8iteratorBare i, int b) const { return hexValue(((utf8iteratorBare::base_type)i)[(127 - b) >> 2]); }
-	auto testPackedBitsetAt(utf8iteratorBare i, int b) const { return (packedBitsetNibbleAt(i, b) & packedBitsetMask(b)) != 0; }
-
-	utf8iteratorBare cbegin() const noexcept { return fsm.data(); }
-	// (N.B. - fsm.size() MAY not be useful, but fsm.data() WILL point to text)
-	utf8iteratorBare cend() const { return fsm.data() + (fsm[0] == '#' ? 1 + LengthSize + decodeLengthAt(fsm.data() + 1) : std::strlen(fsm.data())); }
-
-public:
-	/*
-		Using the rglob::matcher constructor is considered an "expert" level of
-		use of the rglob system... it is far more likely that you will be using
-		the rglob::glob class - it's easier and really made for most situations.
+	// (minimum target text to vector scan for a "fast path" class - for less,
+	// building the classTable for it costs more than a simple scan)
+	static constexpr size_t VectorScanMin = 64;
 
-		That said, if you DO choose to access rglob functionality at the lower
-		level of using the compiler and matcher classes directly, note that the
-		ONLY supported values for the matcher constructor(s) are those returned
-		from the compiler::machine function... which by definition only returns
-		well-formed finite state machines, composed of valid sequences.
+	char header() const noexcept { return fsm.empty() ? '\0' : fsm.front(); }
+	const char* cbegin() const noexcept { return fsm.data(); }
+	template<class Format>
+	const char* cend() const { return detail::decodeHeader<Format>(fsm.data()).last; }
 
-		This last bit is really just a disclaimer saying "we trust our own data
-		and may therefore be a bit relaxed in our internal error-checking".
+	/*
+		testClass evaluates the code point c for membership in the "interpreted"
+		character class whose members (single and range match exprs) are found
+		between first and last - the resulting match success takes into account
+		the "inversion" status of the class.
 	*/
-	matcher() = delete;
-	matcher(string_view m) : fsm(m) {}
+	template<class Format, class Probe>
+	static bool testClass(const char* first, const char* last, bool invert, char32_t c, Probe& probe) {
+		if constexpr (Format::RangesOnly) {
+			// (local fn to decode the low [k = 0] or high [k = 1] end of range i)
+			auto at = [=, &probe](size_t i, size_t k) {
+				auto mi = first + i * Format::RangeWidth;
+				if (k == 1)
+					probe.op(mi);
+				mi += 1 + k * sizeof(char32_t);
+				return Format::decodeCodePoint(mi);
+			};
+			// (binary search for the first range NOT entirely below c...)
+			const auto n = (size_t)(last - first) / Format::RangeWidth;
+			size_t lo = 0;
+			for (auto hi = n; lo < hi;)
+				if (const auto mid = lo + (hi - lo) / 2; at(mid, 1) < c)
+					lo = mid + 1;
+				else
+					hi = mid;
+			// (... which is a match IFF c isn't below it)
+			if (lo != n && at(lo, 0) <= c)
+				return !invert;
+		} else
+			for (auto mi = first; mi != last;)
+				if (probe.op(mi); *mi++ == '+') {
+					if (const auto p = Format::decodeCodePoint(mi); p == c)
+						return !invert;
+					else if (p > c)
+						break; // (all following members are [sorted] above c)
+				} else {
+					const auto p1 = Format::decodeCodePoint(mi), p2 = Format::decodeCodePoint(mi);
+					if (p1 <= c && c <= p2)
+						return !invert;
+					else if (p1 > c)
+						break;
+				}
+		return invert;
+	}
 
 	/*
-		match accepts a [UTF-8] "target" string and attempts to match it to the
-		pattern that was previously processed by compiler::compile, reflecting
-		the match success/failure as its return value.
+		describeWith scans the finite state machine in the specified Format ONCE,
+		to extract the literals that any matching target must contain: the exact
+		match sequences at the very start and end of the machine (if any), which
+		are "anchored" there, and the longest... since globs have NO alternation.
+		The bounds on the length of any matching target come from the header.
 
-		invalid_argument if the target string is NOT valid UTF-8
+		The longest literal is only "required" (searched for before matching) if
+		the machine would NOT otherwise look for it first thing - i.e., if it is
+		not itself anchored, and does not directly follow the first '*'.
 	*/
-	bool match(string_view target) const {
-		// make SURE target is *structurally* valid UTF8
-		if (!detail::validateUTF8String(target))
-			throw std::invalid_argument("Target string is not valid UTF-8.");
-		auto anchored = true, invert = false;
-		utf8iteratorBare next = nullptr;
-		utf8iterator ti = target.cbegin();
-		// iterate over the previously compiled pattern representation, consuming
-		// recognized (matched) elements of the target text
-		for (auto first = cbegin(), mi = first, last = cend(); mi != last;)
-			switch (*mi++) {
-			case '#':
-				// "no-op" from the perspective of matching
-				mi += LengthSize;
-				break;
-			case '?':
-				// accept ("match") single target code point
-				anchored = true, ++ti;
-				break;
-			case '*':
-				// set "free" or "floating" match meta state; this MAY involve
-				// "skipping over" zero or more target code points
-				anchored = false;
+	template<class Format>
+	void describeWith() {
+		const auto h = detail::decodeHeader<Format>(cbegin());
+		const auto last = h.last;
+		auto mi = h.first;
+		shortest = h.least, widest = h.most;
+		char op = 0;
+		size_t k = 0, star = string::npos, at = string::npos;
+		string_view v;
+		for (; mi != last; k++)
+			switch (op = *mi++) {
+			case '*':
+				if (star == string::npos)
+					star = k;
 				break;
+			case '.':
+			case '{':
 			case '[':
-				// prep for full "interpreted" UTF-8 character class recognition
-				invert = decodeModifierAt(mi) != 0;
-				next = mi + 1 + LengthSize + decodeLengthAt(mi + 1) + 1, mi += 1 + LengthSize;
+				// (class ops only refer to their body in the class table)
+				Format::decodeLength(mi);
 				break;
-			case '{':
-				// perform "fast path" (all-ASCII) character class match
-				if (anchored) {
-					if (const auto tx = *ti; !(isascii(tx) && testPackedBitsetAt(mi, tx)))
-						return false;
-					// (consume target code point(s) and skip to after the ']')
-					++ti, mi += 32;
-				} else {
-					auto i = std::find_if(ti, utf8iterator(target.cend()), [=](char32_t tx) { return isascii(tx) && testPackedBitsetAt(mi, tx); });
-					if (i == target.cend())
-						return false;
-					// (consume target code point(s) and skip to after the ']')
-					ti = ++i, anchored = true, mi += 32;
-				}
+			case '~':
+				// (text compared ignoring case is NOT a literal the target contains)
+				mi += Format::decodeLength(mi);
 				break;
-			case '+': {
-				// attempt to match single "interpreted" character class code point
-				const auto p = *mi++;
-				if (anchored) {
-					if (const auto tx = *ti; (p == tx) == !invert)
-						// (consume target code point(s) and skip to after the ']')
-						++ti, mi = next;
-				} else {
-					auto i = std::find_if(ti, utf8iterator(target.cend()), [=](char32_t tx) { return (p == tx) == !invert; });
-					if (i != target.cend())
-						// (consume target code point(s) and skip to after the ']')
-						ti = ++i, anchored = true, mi = next;
-				}
+			case '=': {
+				const auto n = Format::decodeLength(mi);
+				v = string_view(mi, n), mi += n;
+				if (k == 0)
+					head = v;
+				if (n > longest.size())
+					longest = v, at = k;
 				break;
 			}
-			case '-': {
-				// attempt to match "interpreted" character class "range" code point
-				const auto p1 = *mi++, p2 = *mi++;
-				if (anchored) {
-					const auto tx = *ti;
-					if ((p1 <= tx && tx <= p2) == !invert)
-						// (consume target code point(s) and skip to after the ']')
-						++ti, mi = next;
-				} else {
-					auto i = std::find_if(ti, utf8iterator(target.cend()), [=](char32_t tx) { return (p1 <= tx && tx <= p2) == !invert; });
-					if (i != target.cend())
-						// (consume target code point(s) and skip to after the ']')
-						ti = ++i, anchored = true, mi = next;
+			}
+		if (op == '=' && k > 1)
+			tail = v;
+		if (star != string::npos && at != string::npos && at > star + 1 && at != k - 1)
+			required = longest;
+	}
+
+	/*
+		prefilter performs the "cheap" rejection of targets - by length (in O(1),
+		against the bounds recorded in the header of the machine), and with
+		simple compares against the literals found by describeWith - up front, so
+		that the [vast] majority of targets that do NOT match never reach the more
+		costly execution of the machine at all.
+	*/
+	bool prefilter(string_view t) const noexcept {
+		if (t.size() < shortest || t.size() > widest || !t.starts_with(head) || !t.ends_with(tail))
+			return false;
+		return required.empty() || detail::findString(t.substr(0, t.size() - tail.size()), required, head.size()) != string::npos;
+	}
+
+	/*
+		matchWith performs the actual work of match (below), executing the finite
+		state machine in the specified Format.
+
+		The elements of the machine between two '*' ops (or the start / end of the
+		machine) make up a "segment", and every segment matches a FIXED number of
+		target code points... which means that the classic "two-pointer" wildcard
+		matching approach is correct here: having found the leftmost position at
+		which a segment following a '*' matches, no later choices for any EARLIER
+		'*' can do any better, so only the most recent '*' need ever be "retried"
+		(by restarting its segment one code point later in the target).
+
+		This bounds the worst case running time at O(n*m) - for n code points in
+		the target and m ops in the machine - and notably, with NO recursion and
+		NO allocations, whatever the pattern supplied to compile.
+
+		N.B. - the ops executed are those between first and last, so that batch
+		callers (like match_many) need only locate them ONCE... and the execution
+		is reported to the Probe (see detail::noProbe) as it happens - including
+		the text consumed by wildcards, for captures (see match_span).
+
+		The target is iterated over by code point with an Iterator - which is a
+		utf8iterator in general, but for an ALL-ASCII target (where every code
+		point is a single BYTE) may be a plain string_view::const_iterator, so
+		that matching is done byte-wise, with NO decoding at all.
+	*/
+	template<class Format, class Iterator = utf8iterator, class Probe = detail::noProbe>
+	static bool matchWith(const char* first, const char* last, string_view target, Probe&& probe = {}) {
+		const Iterator end = target.cend();
+		Iterator ti = target.cbegin();
+		// (the most recent '*' - if any - and where its segment started matching)
+		const char* star = nullptr;
+		Iterator restart = ti;
+		auto anchored = true;
+		// iterate over the previously compiled pattern representation, consuming
+		// recognized (matched) elements of the target text
+		for (auto mi = first;;) {
+			auto matched = true;
+			if (mi == last) {
+				// we [successfully] consumed ALL target text OR the pattern ended in
+				// a "free" or "floating" match state (e.g.,  "ab*" matches "abZ")
+				// (where the text consumed by any floating '*' extends to the end)
+				if (ti == end || !anchored)
+					return anchored || (probe.anchor(target.size()), true);
+				matched = false;
+			} else
+				switch (probe.op(mi); *mi++) {
+				case Format::Header:
+					// "no-op" from the perspective of matching (but skip the length
+					// and bounds)
+					mi = detail::decodeHeader<Format>(mi - 1).first;
+					break;
+				case '?': {
+					// accept ("match") single target code point
+					if (ti == end)
+						return probe.reject(), false;
+					if (!anchored)
+						restart = ti, anchored = true, probe.anchor((size_t)(ti - target.cbegin()));
+					const auto o = (size_t)(ti - target.cbegin());
+					++ti, probe.skip(o, (size_t)(ti - target.cbegin()));
+					break;
 				}
-				break;
+				case '.': {
+					// accept ("match") a run of N target code points
+					if (!anchored)
+						restart = ti, anchored = true, probe.anchor((size_t)(ti - target.cbegin()));
+					const auto o = (size_t)(ti - target.cbegin());
+					for (auto n = Format::decodeLength(mi); n != 0; n--, ++ti)
+						if (ti == end)
+							return probe.reject(), false;
+					probe.skip(o, (size_t)(ti - target.cbegin()));
+					break;
+				}
+				case '*':
+					// set "free" or "floating" match meta state; this MAY involve
+					// "skipping over" zero or more target code points
+					star = mi, anchored = false, probe.star((size_t)(ti - target.cbegin()));
+					break;
+				case '{': {
+					// perform "fast path" (all-ASCII) character class match
+					const auto bits = last + Format::decodeLength(mi) + 1;
+					if (const auto f = [=](char32_t tx) { return isascii(tx) && Format::testBitset(bits, tx); }; anchored) {
+						if (matched = ti != end && f(*ti); !matched)
+							break;
+					} else if (const auto o = (size_t)(ti - target.cbegin()); target.size() - o < VectorScanMin) {
+						// (find the leftmost place where this segment CAN start)
+						ti = std::find_if(ti, end, f), probe.floating((size_t)(ti - target.cbegin()) - o);
+						if (ti == end)
+							return probe.reject(), false;
+						restart = ti, anchored = true, probe.anchor((size_t)(ti - target.cbegin()));
+					} else {
+						// (... faster, with a vector scan - see detail::findInClass)
+						const auto i = o + detail::findInClass(target.data() + o, target.size() - o, detail::classTable(Format::decodeBitset(bits)));
+						if (probe.floating(i - o); i == target.size())
+							return probe.reject(), false;
+						restart = ti = target.cbegin() + i, anchored = true, probe.anchor(i);
+					}
+					// (consume target code point(s))
+					++ti;
+					break;
+				}
+				case '[': {
+					// perform full "interpreted" UTF-8 character class match
+					auto ci = last + Format::decodeLength(mi) + 1;
+					const auto invert = Format::decodeModifier(ci++);
+					const auto n = Format::decodeLength(ci);
+					const auto first = ci, next = first + n;
+					if (const auto f = [=, &probe](char32_t tx) { return testClass<Format>(first, next, invert, tx, probe); }; anchored) {
+						if (matched = ti != end && f(*ti); !matched)
+							break;
+					} else {
+						// (find the leftmost place where this segment CAN start)
+						const auto o = ti;
+						ti = std::find_if(ti, end, f), probe.floating((size_t)(ti - o));
+						if (ti == end)
+							return probe.reject(), false;
+						restart = ti, anchored = true, probe.anchor((size_t)(ti - target.cbegin()));
+					}
+					// (consume target code point(s))
+					++ti;
+					break;
+				}
+				case '=': {
+					// attempt an exact sequence of UTF-8 code points match
+					const auto n = Format::decodeLength(mi);
+					const auto o = (size_t)(ti - target.cbegin());
+					const string_view v(mi, n);
+					if (anchored) {
+						if (matched = target.substr(o).starts_with(v); !matched)
+							break;
+					} else {
+						// (find the leftmost place where this segment CAN start)
+						const auto i = detail::findString(target, v, o);
+						if (i == string::npos)
+							return probe.floating(target.size() - o), probe.reject(), false;
+						probe.floating(i - o);
+						restart = ti = target.cbegin() + i, anchored = true, probe.anchor(i);
+					}
+					ti += n, mi += n;
+					break;
+				}
+				case '~': {
+					// attempt the same, but ignoring ASCII case (see ignore_case)
+					const auto n = Format::decodeLength(mi);
+					const auto o = (size_t)(ti - target.cbegin());
+					const string_view v(mi, n);
+					if (anchored) {
+						if (matched = target.size() - o >= n && detail::equalFolded(target.data() + o, v.data(), n); !matched)
+							break;
+					} else {
+						// (find the leftmost place where this segment CAN start)
+						const auto i = detail::findFolded(target, v, o);
+						if (i == string::npos)
+							return probe.floating(target.size() - o), probe.reject(), false;
+						probe.floating(i - o);
+						restart = ti = target.cbegin() + i, anchored = true, probe.anchor(i);
+					}
+					ti += n, mi += n;
+					break;
+				}
+				}
+			if (!matched) {
+				// retry the segment following the most recent '*' (if there IS one)
+				// ONE code point later... UNLESS we have run out of target text
+				if (star == nullptr || restart == end)
+					return probe.reject(), false;
+				ti = ++restart, mi = star, anchored = false, probe.retry();
 			}
-			case ']':
-				// end of "interpreted" UTF-8 character class... if we get here, it
-				// means we did NOT match ANY target code point - i.e., "failure"
-				return false;
-			case '=': {
-				// attempt an exact sequence of UTF-8 code points match
-				const auto n = decodeLengthAt(mi);
-				const auto o = ti - target.cbegin();
-				const auto i = target.find(mi + LengthSize, o, n);
-				// (below means "not found" OR "found, but not where expected")
-				if (i == string::npos || (anchored && i != o))
+		}
+	}
+
+	/*
+		matchDecodedWith is the equivalent of matchWith (above) for targets NOT in
+		UTF-8 - e.g., in UTF-16 - where the Iterator yields the [decoded] target
+		code points themselves: as there are then no BYTEs to compare (or to scan
+		with vector instructions), exact match text is compared to the target one
+		code point at a time, and searched for by simply trying each position.
+	*/
+	template<class Format, class Iterator>
+	static bool matchDecodedWith(const char* first, const char* last, Iterator ti, const Iterator end) {
+		// (whether the exact match text v is next in the target, consuming it)
+		auto starts = [&](Iterator& t, string_view v, bool fold) {
+			for (utf8iteratorBare u = v.data(), e = u + v.size(); u != e; ++u, ++t)
+				if (t == end || (fold ? detail::foldASCII((char32_t)*t) : (char32_t)*t) != *u)
 					return false;
-				ti = anchored ? ti + n : utf8iterator(target.cbegin() + i + n), anchored = true, mi += LengthSize + n;
-				break;
-			}
+			return true;
+		};
+		// (the most recent '*' - if any - and where its segment started matching)
+		const char* star = nullptr;
+		Iterator restart = ti;
+		auto anchored = true;
+		for (auto mi = first;;) {
+			auto matched = true;
+			if (mi == last) {
+				if (ti == end || !anchored)
+					return true;
+				matched = false;
+			} else
+				switch (*mi++) {
+				case Format::Header:
+					mi = detail::decodeHeader<Format>(mi - 1).first;
+					break;
+				case '?':
+				case '.':
+					// accept ("match") one - or a run of N - target code points
+					if (!anchored)
+						restart = ti, anchored = true;
+					for (auto n = mi[-1] == '?' ? 1 : Format::decodeLength(mi); n != 0; n--, ++ti)
+						if (ti == end)
+							return false;
+					break;
+				case '*':
+					star = mi, anchored = false;
+					break;
+				case '{':
+				case '[': {
+					// perform either kind of character class match (see matchWith)
+					const auto bits = mi[-1] == '{';
+					auto ci = last + Format::decodeLength(mi) + 1;
+					auto invert = false;
+					size_t n = 0;
+					if (!bits)
+						invert = Format::decodeModifier(ci++), n = Format::decodeLength(ci);
+					const auto f = [=](char32_t tx) {
+						detail::noProbe probe;
+						return bits ? isascii(tx) && Format::testBitset(ci, tx) : testClass<Format>(ci, ci + n, invert, tx, probe);
+					};
+					if (anchored) {
+						if (matched = ti != end && f((char32_t)*ti); !matched)
+							break;
+					} else {
+						// (find the leftmost place where this segment CAN start)
+						while (ti != end && !f((char32_t)*ti))
+							++ti;
+						if (ti == end)
+							return false;
+						restart = ti, anchored = true;
+					}
+					// (consume target code point)
+					++ti;
+					break;
+				}
+				case '=':
+				case '~': {
+					// attempt an exact (or ignoring ASCII case) code points match
+					const auto fold = mi[-1] == '~';
+					const auto n = Format::decodeLength(mi);
+					const string_view v(mi, n);
+					mi += n;
+					if (anchored) {
+						if (matched = starts(ti, v, fold); !matched)
+							break;
+					} else
+						// (find the leftmost place where this segment CAN start)
+						for (;; ++ti)
+							if (ti == end)
+								return false;
+							else if (auto t = ti; starts(t, v, fold)) {
+								restart = ti, ti = t, anchored = true;
+								break;
+							}
+					break;
+				}
+				}
+			if (!matched) {
+				// retry the segment following the most recent '*' (if there IS one)
+				// ONE code point later... UNLESS we have run out of target text
+				if (star == nullptr || restart == end)
+					return false;
+				ti = ++restart, mi = star, anchored = false;
 			}
-		// return whether we [successfully] consumed ALL target text OR the pattern
-		// ended in a "free" or "floating" match state (e.g.,  "ab*" matches "abZ")
-		return ti == target.cend() || !anchored;
+		}
 	}
 
 	/*
-		pretty_print outputs a formatted representation of the current finite
-		state machine produced by compiler::compile to the supplied ostream
-		(with optional layout "prefix" per line).
+		matchDecoded performs the actual work of match (below) for a [UTF-16 or
+		UTF-32] target already known to be valid, which would take bytes BYTEs in
+		UTF-8... so that the length bounds of the machine apply as for UTF-8.
 	*/
-	void pretty_print(std::ostream& s, string_view pre = "") const {
+	template<class Iterator>
+	bool matchDecoded(Iterator ti, Iterator end, size_t bytes) const {
+		const auto fits = bytes >= shortest && bytes <= widest;
+		switch (header()) {
+		case detail::binaryFormat::Header:
+			return fits && matchDecodedWith<detail::binaryFormat>(cbegin(), cend<detail::binaryFormat>(), ti, end);
+		case detail::textFormat::Header:
+			return fits && matchDecodedWith<detail::textFormat>(cbegin(), cend<detail::textFormat>(), ti, end);
+		}
+		// (the "empty" pattern matches ONLY the empty target)
+		return ti == end;
+	}
+
+	/*
+		matchKnown performs the actual work of match (below) for a target already
+		known to be valid UTF-8, after the prefilter: a target that is ALSO known
+		to be ALL-ASCII (bytes) is matched byte-wise, and any other by UTF-8 code
+		point (see matchWith).
+
+		N.B. - a target is only known to be ALL-ASCII when that was found "for
+		free" while validating it... scanning a trusted target ONLY to find this
+		out costs more than byte-wise matching saves.
+	*/
+	bool matchKnown(string_view target, bool bytes) const {
+		switch (header()) {
+		case detail::binaryFormat::Header:
+			return prefilter(target) && (bytes ?
+				matchWith<detail::binaryFormat, string_view::const_iterator>(cbegin(), cend<detail::binaryFormat>(), target) :
+				matchWith<detail::binaryFormat>(cbegin(), cend<detail::binaryFormat>(), target));
+		case detail::textFormat::Header:
+			return prefilter(target) && (bytes ?
+				matchWith<detail::textFormat, string_view::const_iterator>(cbegin(), cend<detail::textFormat>(), target) :
+				matchWith<detail::textFormat>(cbegin(), cend<detail::textFormat>(), target));
+		}
+		// (the "empty" pattern matches ONLY the empty target)
+		return target.empty();
+	}
+
+	/*
+		matchManyWith performs the actual work of match_many (below), executing the
+		finite state machine in the specified Format for each target in turn.
+	*/
+	template<class Format>
+	void matchManyWith(std::span<const string_view> targets, std::span<std::uint8_t> results) const {
+		// (locate the ops following the header just ONCE, for ALL the targets)
+		const auto h = detail::decodeHeader<Format>(cbegin());
+		const auto first = h.first, last = h.last;
+		std::transform(targets.begin(), targets.end(), results.begin(), [=, this](string_view t) {
+			return (std::uint8_t)(prefilter(t) && matchWith<Format>(first, last, t));
+		});
+	}
+
+	/*
+		printWith performs the actual work of pretty_print (below), displaying the
+		finite state machine in the specified Format.
+	*/
+	template<class Format>
+	void printWith(std::ostream& s, string_view pre) const {
 		// (local fn to compute width for Unicode representation)
 		auto w = [](char32_t c) { return c < 0x010000 ? 4 : c < 0x100000 ? 5 : 6; };
+		// (local fn to determine if a char can be shown "as is", i.e., as ASCII)
+		auto printable = [](char32_t c) { return c >= ' ' && c < 0x7f; };
 		// (local fn to show Unicode char as ASCII if we can, else use "U+..." form)
 		auto a = [&](char32_t c) -> std::ostream& {
 			return
-				isascii(c) ?
+				printable(c) ?
 				s << (char)c :
 				s << "U+" << std::hex << std::uppercase << std::setfill('0') << std::setw(w(c))
 				<< (int)c
 				<< std::dec << std::setfill(' ');
 		};
-		// iterate over each element of finite state machine...
-		for (auto first = cbegin(), mi = first, last = cend(); mi != last;) {
+		// iterate over each element of finite state machine AND its class table...
+		const auto first = cbegin(), table = cend<Format>();
+		for (auto mi = first, last = first + fsm.size(); mi != last;) {
 			const auto op = *mi++;
+			if (mi - 1 == table)
+				s << pre << "------ classes" << std::endl;
 			s << pre << "[" << std::setw(4) << (mi - first - 1) << "] op: " << (char)op;
 			switch (op) {
-			case '#':
-				// display length of compiled pattern
-				s << " len: " << decodeLengthAt(mi);
-				mi += LengthSize;
+			case Format::Header:
+				// display length and bounds of compiled pattern (max 0 is "none")
+				s << " len: " << Format::decodeLength(mi);
+				s << " min: " << Format::decodeLength(mi);
+				s << " max: " << Format::decodeLength(mi);
+				break;
+			case '.':
+				// display number of target code points skipped
+				s << " len: " << Format::decodeLength(mi);
 				break;
 			case '[':
-				// display control metadata from "interpreted" character class
-				s << " mod: " << (char)*mi << " len: " << decodeLengthAt(mi + 1);
-				mi += 1 + LengthSize;
+				if (mi <= table)
+					// display reference from class op to its body in the class table
+					s << " cls: " << (table - first) + Format::decodeLength(mi);
+				else
+					// display control metadata from "interpreted" character class
+					s << " mod: " << (Format::decodeModifier(mi++) ? 1 : 0),
+					s << " len: " << Format::decodeLength(mi);
 				break;
 			case '{':
-				// display bitset from "fast path" character class
+				if (mi <= table) {
+					// display reference from class op to its body in the class table
+					s << " cls: " << (table - first) + Format::decodeLength(mi);
+					break;
+				}
+				// display bitset from "fast path" character class (ALWAYS as hex)
 				s << " val: ";
-				std::copy((utf8iteratorBare::base_type)mi, (utf8iteratorBare::base_type)mi + 32, std::ostreambuf_iterator<char>(s));
-				mi += 32;
+				for (auto c = 128 - 4; c >= 0; c -= 4)
+					s << detail::textFormat::hexDigit(
+						(Format::testBitset(mi, c + 0) ? 1 : 0) |
+						(Format::testBitset(mi, c + 1) ? 2 : 0) |
+						(Format::testBitset(mi, c + 2) ? 4 : 0) |
+						(Format::testBitset(mi, c + 3) ? 8 : 0));
+				mi += Format::BitsetWidth;
 				break;
 			case '+':
 				// display SINGLE match case from "interpreted" character class
-				s << " val: ", a(*mi++);
+				s << " val: ", a(Format::decodeCodePoint(mi));
 				break;
 			case '-':
 				// display RANGE match case from "interpreted" character class
-				s << " val: ", a(*mi++) << ' ', a(*mi++);
+				s << " val: ", a(Format::decodeCodePoint(mi)) << ' ', a(Format::decodeCodePoint(mi));
 				break;
-			case '=': {
+			case '=':
+			case '~': {
 				// display "exact match" string from glob pattern
-				const auto n = decodeLengthAt(mi);
+				const auto n = Format::decodeLength(mi);
 				s << " len: " << n << " val:";
 				// "leading space" rules: NEVER show ASCII sequences with embedded
 				// spaces, ALWAYS show [multi-byte] Unicode code points as " U+..."
 				// for each, and ALWAYS insert a space when switching between them.
 				enum LeadingSpace { None, Ascii, Unicode } state = None;
-				std::for_each(mi + LengthSize, mi + LengthSize + n, [&](char32_t c) {
-					if (const auto newState = isascii(c) ? Ascii : Unicode; newState != state || state == Unicode)
+				const utf8iteratorBare v = mi;
+				std::for_each(v, v + n, [&](char32_t c) {
+					if (const auto newState = printable(c) ? Ascii : Unicode; newState != state || state == Unicode)
 						s << ' ', state = newState;
 					a(c);
 				});
-				mi += LengthSize + n;
+				mi += n;
 				break;
 			}
 			}
 			s << std::endl;
 		}
 	}
+
+public:
+	/*
+		Using the rglob::matcher constructor is considered an "expert" level of
+		use of the rglob system... it is far more likely that you will be using
+		the rglob::glob class - it's easier and really made for most situations.
+
+		That said, if you DO choose to access rglob functionality at the lower
+		level of using the compiler and matcher classes directly, note that the
+		ONLY supported values for the matcher constructor(s) are those returned
+		from the compiler::machine function... which by definition only returns
+		well-formed finite state machines, composed of valid sequences.
+
+		This last bit is really just a disclaimer saying "we trust our own data
+		and may therefore be a bit relaxed in our internal error-checking".
+
+		N.B. - a matcher does NOT own the machine it is constructed from, which
+		must therefore outlive it - and NOT be changed through recompiling!
+	*/
+	matcher() = delete;
+	matcher(string_view m) : fsm(m) {
+		switch (header()) {
+		case detail::binaryFormat::Header:
+			describeWith<detail::binaryFormat>();
+			break;
+		case detail::textFormat::Header:
+			describeWith<detail::textFormat>();
+			break;
+		}
+	}
+
+	/*
+		match accepts a [UTF-8] "target" string and attempts to match it to the
+		pattern that was previously processed by compiler::compile, reflecting
+		the match success/failure as its return value.
+
+		invalid_argument if the target string is NOT valid UTF-8
+	*/
+	bool match(string_view target) const {
+		// make SURE target is *structurally* valid UTF8 (N.B. - ALL-ASCII text
+		// is, and that it is ALL-ASCII is exactly what is found first)
+		const auto k = detail::asciiPrefix(target.data(), target.size());
+		if (k != target.size() && !detail::validateUTF8String(target.substr(k)))
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		return matchKnown(target, k == target.size());
+	}
+
+	/*
+		match (with the trusted_utf8 tag) is identical to the above, but without
+		any validation of the target string, which MUST already be known to be
+		valid UTF-8 - e.g., match(trusted_utf8, s).
+	*/
+	bool match(trusted_utf8_t, string_view target) const { return matchKnown(target, false); }
+
+	/*
+		match (with a range of "wide" code units) accepts a target in UTF-16 (of
+		char16_t, or of a 16-bit wchar_t) or UTF-32 (of char32_t, or of a 32-bit
+		wchar_t), and matches it just like the same target in UTF-8 - but with NO
+		transcoding copy... the range may be any [multi-pass] forward range, e.g.,
+		a std::u16string_view, OR a std::deque or some other segmented buffer.
+
+		invalid_argument if the target is NOT valid UTF-16 (or UTF-32)
+
+		N.B. - the [necessary] validation of the target ALSO finds how long it
+		would be in UTF-8, so that the length bounds of the pattern still apply.
+	*/
+	template<std::ranges::forward_range R>
+		requires std::ranges::common_range<R> && detail::wideCodeUnit<std::ranges::range_value_t<R>> && (!std::is_array_v<R>)
+	bool match(const R& target) const {
+		const auto first = std::ranges::begin(target), last = std::ranges::end(target);
+		const auto n = detail::sizeInUTF8(first, last);
+		if (n == string::npos)
+			throw std::invalid_argument("Target string is not valid UTF-16 or UTF-32.");
+		if constexpr (sizeof(std::ranges::range_value_t<R>) == sizeof(char16_t))
+			return matchDecoded(basic_utf16iterator(first), basic_utf16iterator(last), n);
+		else
+			return matchDecoded(first, last, n);
+	}
+	bool match(std::u16string_view target) const { return match<std::u16string_view>(target); }
+	bool match(std::u32string_view target) const { return match<std::u32string_view>(target); }
+	bool match(std::wstring_view target) const { return match<std::wstring_view>(target); }
+
+	/*
+		match (with a match_stats) is identical to the corresponding overload of
+		match above, but ALSO accumulates counts of the work done into stats.
+	*/
+	bool match(string_view target, match_stats& stats) const {
+		// make SURE target is *structurally* valid UTF8
+		if (!detail::validateUTF8String(target))
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		return match(trusted_utf8, target, stats);
+	}
+	bool match(trusted_utf8_t, string_view target, match_stats& stats) const {
+		detail::statsProbe probe{ stats, cbegin() };
+		auto r = false;
+		stats.targets++;
+		if (header() != detail::binaryFormat::Header && header() != detail::textFormat::Header)
+			r = target.empty();
+		else if (!prefilter(target))
+			stats.prefiltered++;
+		else if (header() == detail::binaryFormat::Header)
+			r = matchWith<detail::binaryFormat>(cbegin(), cend<detail::binaryFormat>(), target, probe);
+		else
+			r = matchWith<detail::textFormat>(cbegin(), cend<detail::textFormat>(), target, probe);
+		return stats.matched += r, r;
+	}
+
+	/*
+		match (with a span of match_spans) is identical to the corresponding overload
+		of match above, but ALSO stores the match_span of each wildcard run of the
+		pattern into spans (as many as it can hold), as they are matched - with NO
+		allocations, and NO extra passes over the target.
+
+		N.B. - the spans are only meaningful if the target DOES match, and those
+		of runs beyond the first spans.size() ones are simply not stored.
+	*/
+	bool match(string_view target, std::span<match_span> spans) const {
+		// make SURE target is *structurally* valid UTF8
+		if (!detail::validateUTF8String(target))
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		return match(trusted_utf8, target, spans);
+	}
+	bool match(trusted_utf8_t, string_view target, std::span<match_span> spans) const {
+		detail::captureProbe probe{ spans };
+		switch (header()) {
+		case detail::binaryFormat::Header:
+			return prefilter(target) && matchWith<detail::binaryFormat>(cbegin(), cend<detail::binaryFormat>(), target, probe);
+		case detail::textFormat::Header:
+			return prefilter(target) && matchWith<detail::textFormat>(cbegin(), cend<detail::textFormat>(), target, probe);
+		}
+		return target.empty();
+	}
+
+	/*
+		match_many matches EACH of a batch of [UTF-8] targets against the pattern,
+		storing the match success/failure of targets[i] (as 1 or 0) in results[i]
+		- equivalent to calling match for each, but with all per-call setup (e.g.,
+		locating the ops of the machine) done only ONCE for the whole batch.
+
+		invalid_argument if there are fewer results than targets, OR if any of the
+		targets is NOT valid UTF-8 (in which case NO results are stored)
+	*/
+	void match_many(std::span<const string_view> targets, std::span<std::uint8_t> results) const {
+		// make SURE all targets are *structurally* valid UTF8 - BEFORE matching
+		if (find_invalid_utf8(targets) != targets.size())
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		match_many(trusted_utf8, targets, results);
+	}
+
+	/*
+		match_many (with the trusted_utf8 tag) is identical to the above, but with
+		NO validation of the targets, which MUST already be known to be valid UTF-8.
+
+		invalid_argument if there are fewer results than targets
+	*/
+	void match_many(trusted_utf8_t, std::span<const string_view> targets, std::span<std::uint8_t> results) const {
+		if (results.size() < targets.size())
+			throw std::invalid_argument("Fewer results than targets supplied to match_many.");
+		switch (header()) {
+		case detail::binaryFormat::Header:
+			matchManyWith<detail::binaryFormat>(targets, results);
+			break;
+		case detail::textFormat::Header:
+			matchManyWith<detail::textFormat>(targets, results);
+			break;
+		default:
+			std::transform(targets.begin(), targets.end(), results.begin(), [](string_view t) { return (std::uint8_t)t.empty(); });
+			break;
+		}
+	}
+
+	/*
+		pretty_print outputs a formatted representation of the current finite
+		state machine produced by compiler::compile to the supplied ostream
+		(with optional layout "prefix" per line).
+	*/
+	void pretty_print(std::ostream& s, string_view pre = "") const {
+		switch (header()) {
+		case detail::binaryFormat::Header:
+			printWith<detail::binaryFormat>(s, pre);
+			break;
+		case detail::textFormat::Header:
+			printWith<detail::textFormat>(s, pre);
+			break;
+		}
+	}
+	/*
+		literal returns the longest "exact match" sequence of UTF-8 code points in
+		the pattern (or an empty string_view if there isn't one)... as globs have
+		NO alternation, this sequence MUST appear in any target the pattern will
+		match, which makes it useful for "pre-filtering" targets.
+	*/
+	string_view literal() const noexcept { return longest; }
+
+	/*
+		prefix and suffix return the "exact match" sequences of UTF-8 code points
+		that the pattern starts and ends with, respectively (or empty string_views
+		if it doesn't)... any target the pattern will match MUST start / end with
+		these, which allows match to reject most targets with simple compares.
+
+		N.B. - a pattern that is ONLY an exact match sequence has just a prefix.
+	*/
+	string_view prefix() const noexcept { return head; }
+	string_view suffix() const noexcept { return tail; }
+
+	/*
+		min_length and max_length return the lengths (in BYTEs) of the shortest and
+		longest targets that the pattern could possibly match (where the latter is
+		npos for any pattern with a '*') - targets outside of these are rejected
+		by match with no further work.
+	*/
+	size_t min_length() const noexcept { return shortest; }
+	size_t max_length() const noexcept { return widest; }
 };
 
 /*
-	The glob class is a "glue" class that composes a compiler and a matcher for
-	specifying and subsequently recognizing "glob" -style patterns over text in
-	UTF-8 form.
+	The threaded_matcher class is an alternative "backend" to matcher, intended
+	for long-running uses that compile a pattern ONCE and then match it against
+	very many targets: rather than decoding the machine one op at a time while
+	matching (and dispatching through a single, hard to predict, switch), it
+	decodes the machine - in either form - exactly once, into an array of steps,
+	each of which holds all of its operands in "ready to use" form.
 
-	While certain specialized applications may find it convenient to separately
-	compile and match patterns - and will thus directly make use of the compiler
-	and matcher classes, the expected typical usage is to use the composed class
-	glob to handle all compiling, matching, and pretty-printing functionality.
+	Where the compiler supports it (GCC and Clang), each step also holds the
+	address of the code that handles it, and every handler jumps directly to
+	the handler of the NEXT step (so-called "direct threading", through the
+	"labels as values" extension)... which gives each handler its OWN indirect
+	branch to predict. Elsewhere (or if RGLOB_NO_THREADED is defined), the steps
+	are dispatched with a switch, which still avoids all of the op decoding.
 
-	Note that when using glob, there is no need to refer to or use the compiler
-	or matcher classes (or their constructors) at all: just create a glob object
-	and invoke its compile and match (or pretty_print) functions directly.
+	Apart from this, the semantics of threaded_matcher::match are exactly the
+	same as those of matcher::match.
+
+	N.B. - unlike a matcher, a threaded_matcher does NOT refer to the machine it
+	is constructed from once constructed, which may then be freely discarded.
 */
-class glob : public compiler, public matcher
+class threaded_matcher
 {
+	enum class op : std::uint8_t { end, any, star, bits, range, exact, skip, fold };
+
+	struct step
+	{
+#if defined(RGLOB_THREADED)
+		const void* handler = nullptr;	// (address of the code for this op)
+#endif
+		op code = op::end;
+		bool invert = false;			// ("interpreted" class is inverted)
+		std::uint32_t at = 0, n = 0;	// (operand position and length / count)
+	};
+
+	std::vector<step> steps;			// pre-decoded steps, ending in op::end
+	std::vector<detail::classTable> bits;// tables of "fast path" classes
+	std::vector<std::pair<char32_t, char32_t>> ranges;// "interpreted" members
+	string text;						// UTF-8 code points of exact matches
+	size_t least = 0, most = string::npos;// target length bounds (in BYTEs)
+
+	/*
+		load decodes the finite state machine in the specified Format into steps,
+		copying all operands (which are laid out the same way for either Format).
+	*/
+	template<class Format>
+	void load(const char* mi) {
+		const auto h = detail::decodeHeader<Format>(mi);
+		const auto last = h.last;
+		mi = h.first, least = h.least, most = h.most;
+		// (classes are shared in the machine, so share their decoded operands too)
+		std::vector<std::pair<size_t, size_t>> seen;// (class offset, first step)
+		auto shared = [&](size_t o) {
+			const auto i = std::find_if(seen.cbegin(), seen.cend(), [&](auto& e) { return e.first == o; });
+			if (i == seen.cend())
+				return seen.emplace_back(o, steps.size()), false;
+			steps.push_back(steps[i->second]);
+			return true;
+		};
+		while (mi != last)
+			switch (*mi++) {
+			case '?':
+				steps.push_back({ .code = op::any });
+				break;
+			case '.':
+				steps.push_back({ .code = op::skip, .n = (std::uint32_t)Format::decodeLength(mi) });
+				break;
+			case '*':
+				steps.push_back({ .code = op::star });
+				break;
+			case '{': {
+				const auto o = Format::decodeLength(mi);
+				if (shared(o))
+					break;
+				steps.push_back({ .code = op::bits, .at = (std::uint32_t)bits.size() });
+				bits.emplace_back(Format::decodeBitset(last + o + 1));
+				break;
+			}
+			case '[': {
+				const auto o = Format::decodeLength(mi);
+				if (shared(o))
+					break;
+				auto ci = last + o + 1;
+				const auto invert = Format::decodeModifier(ci++);
+				const auto n = Format::decodeLength(ci);
+				const auto at = ranges.size();
+				for (const auto next = ci + n; ci != next;)
+					if (*ci++ == '+') {
+						const auto c = Format::decodeCodePoint(ci);
+						ranges.emplace_back(c, c);
+					} else {
+						const auto c1 = Format::decodeCodePoint(ci), c2 = Format::decodeCodePoint(ci);
+						ranges.emplace_back(c1, c2);
+					}
+				steps.push_back({ .code = op::range, .invert = invert, .at = (std::uint32_t)at, .n = (std::uint32_t)(ranges.size() - at) });
+				break;
+			}
+			case '=':
+			case '~': {
+				const auto code = mi[-1] == '=' ? op::exact : op::fold;
+				const auto n = Format::decodeLength(mi);
+				steps.push_back({ .code = code, .at = (std::uint32_t)text.size(), .n = (std::uint32_t)n });
+				text.append(mi, n), mi += n;
+				break;
+			}
+			}
+		steps.push_back({ .code = op::end });
+	}
+
+	/*
+		run performs the actual work of match (below), executing the pre-decoded
+		steps with the same "two-pointer" approach as matcher::matchWith, where
+		only the most recent '*' is ever "retried".
+
+		N.B. - when threading, the handler addresses are only known INSIDE this
+		function, so it is also [first] called with a non-null labels, in which
+		case it simply returns the address of each handler (in op order).
+	*/
+	bool run(string_view target, [[maybe_unused]] const void* const** labels = nullptr) const {
+#if defined(RGLOB_THREADED)
+		static const void* const handlers[] = { &&op_end, &&op_any, &&op_star, &&op_bits, &&op_range, &&op_exact, &&op_skip, &&op_fold };
+		if (labels != nullptr)
+			return *labels = handlers, false;
+#define RGLOB_CASE(x) op_##x
+#define RGLOB_DISPATCH() goto *si->handler
+#else
+#define RGLOB_CASE(x) case op::x
+#define RGLOB_DISPATCH() continue
+#endif
+		// (as for matcher, reject targets outside the bounds from the header)
+		if (target.size() < least || target.size() > most)
+			return false;
+		const utf8iterator end = target.cend();
+		utf8iterator ti = target.cbegin();
+		// (the most recent '*' - if any - and where its segment started matching)
+		const step* star = nullptr;
+		utf8iterator restart = ti;
+		auto anchored = true;
+		auto si = steps.data();
+		for (;;) {
+#if defined(RGLOB_THREADED)
+			RGLOB_DISPATCH();
+#else
+			switch (si->code) {
+#endif
+			RGLOB_CASE(end):
+				// (as for matcher, consumed ALL target text OR in "floating" state)
+				if (ti == end || !anchored)
+					return true;
+				goto retry;
+			RGLOB_CASE(any):
+				if (ti == end)
+					return false;
+				if (!anchored)
+					restart = ti, anchored = true;
+				++ti, ++si;
+				RGLOB_DISPATCH();
+			RGLOB_CASE(star):
+				star = ++si, anchored = false;
+				RGLOB_DISPATCH();
+			RGLOB_CASE(bits): {
+				const auto& t = bits[si->at];
+				if (anchored) {
+					if (ti == end || !t.test(*ti))
+						goto retry;
+				} else {
+					// (as no "fast path" member is multi-byte, scan bytes - NOT chars)
+					const auto o = (size_t)(ti - target.cbegin());
+					const auto i = o + detail::findInClass(target.data() + o, target.size() - o, t);
+					if (i == target.size())
+						return false;
+					restart = ti = target.cbegin() + i, anchored = true;
+				}
+				++ti, ++si;
+				RGLOB_DISPATCH();
+			}
+			RGLOB_CASE(range): {
+				const auto first = ranges.data() + si->at, last = first + si->n;
+				const auto invert = si->invert;
+				const auto f = [=](char32_t tx) {
+					return detail::inRanges(first, last, tx) != invert;
+				};
+				if (anchored) {
+					if (ti == end || !f(*ti))
+						goto retry;
+				} else {
+					if (ti = std::find_if(ti, end, f); ti == end)
+						return false;
+					restart = ti, anchored = true;
+				}
+				++ti, ++si;
+				RGLOB_DISPATCH();
+			}
+			RGLOB_CASE(exact): {
+				const auto o = (size_t)(ti - target.cbegin());
+				const string_view v(text.data() + si->at, si->n);
+				if (anchored) {
+					if (!target.substr(o).starts_with(v))
+						goto retry;
+				} else {
+					const auto i = detail::findString(target, v, o);
+					if (i == string::npos)
+						return false;
+					restart = ti = target.cbegin() + i, anchored = true;
+				}
+				ti += v.size(), ++si;
+				RGLOB_DISPATCH();
+			}
+			RGLOB_CASE(skip):
+				if (!anchored)
+					restart = ti, anchored = true;
+				for (auto n = si->n; n != 0; n--, ++ti)
+					if (ti == end)
+						return false;
+				++si;
+				RGLOB_DISPATCH();
+			RGLOB_CASE(fold): {
+				const auto o = (size_t)(ti - target.cbegin());
+				const string_view v(text.data() + si->at, si->n);
+				if (anchored) {
+					if (target.size() - o < v.size() || !detail::equalFolded(target.data() + o, v.data(), v.size()))
+						goto retry;
+				} else {
+					const auto i = detail::findFolded(target, v, o);
+					if (i == string::npos)
+						return false;
+					restart = ti = target.cbegin() + i, anchored = true;
+				}
+				ti += v.size(), ++si;
+				RGLOB_DISPATCH();
+			}
+#if !defined(RGLOB_THREADED)
+			}
+#endif
+		retry:
+			// retry the segment following the most recent '*' (if there IS one)
+			// ONE code point later... UNLESS we have run out of target text
+			if (star == nullptr || restart == end)
+				return false;
+			ti = ++restart, si = star, anchored = false;
+		}
+#undef RGLOB_CASE
+#undef RGLOB_DISPATCH
+	}
+
 public:
-	glob() : compiler(), matcher(compiler::machine()) {}
+	/*
+		As for matcher, the ONLY supported values for the threaded_matcher
+		constructor are those returned from the compiler::machine function (in
+		either the text or binary form).
+	*/
+	threaded_matcher() = delete;
+	threaded_matcher(string_view m) {
+		switch (m.empty() ? '\0' : m.front()) {
+		case detail::binaryFormat::Header:
+			load<detail::binaryFormat>(m.data());
+			break;
+		case detail::textFormat::Header:
+			load<detail::textFormat>(m.data());
+			break;
+		default:
+			// (the "empty" pattern matches ONLY the empty target)
+			steps.push_back({ .code = op::end });
+			break;
+		}
+#if defined(RGLOB_THREADED)
+		// (resolve each step's handler address - ONCE - before any matching)
+		const void* const* handlers = nullptr;
+		run({}, &handlers);
+		for (auto& s : steps)
+			s.handler = handlers[(size_t)s.code];
+#endif
+	}
+
+	/*
+		match accepts a [UTF-8] "target" string and attempts to match it to the
+		pattern, reflecting the match success/failure as its return value.
+
+		invalid_argument if the target string is NOT valid UTF-8
+	*/
+	bool match(string_view target) const {
+		// make SURE target is *structurally* valid UTF8
+		if (!detail::validateUTF8String(target))
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		return run(target);
+	}
+
+	/*
+		match (with the trusted_utf8 tag) is identical to the above, but without
+		any validation of the target string, which MUST already be known to be
+		valid UTF-8 - e.g., match(trusted_utf8, s).
+	*/
+	bool match(trusted_utf8_t, string_view target) const { return run(target); }
+
+	/*
+		match_many (both with and without the trusted_utf8 tag) is as for matcher.
+	*/
+	void match_many(std::span<const string_view> targets, std::span<std::uint8_t> results) const {
+		// make SURE all targets are *structurally* valid UTF8 - BEFORE matching
+		if (find_invalid_utf8(targets) != targets.size())
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		match_many(trusted_utf8, targets, results);
+	}
+	void match_many(trusted_utf8_t, std::span<const string_view> targets, std::span<std::uint8_t> results) const {
+		if (results.size() < targets.size())
+			throw std::invalid_argument("Fewer results than targets supplied to match_many.");
+		std::transform(targets.begin(), targets.end(), results.begin(), [this](string_view t) { return (std::uint8_t)run(t); });
+	}
+};
+
+/*
+	The stream_matcher class matches targets which are NOT available all at once,
+	but arrive as a series of "chunks" (e.g., from a network connection), each
+	of which is supplied in turn to the feed function of a match_state obtained
+	from stream_matcher::start - with no need to buffer the target at all.
+
+	Since the "retrying" of matcher::match would require going BACK to earlier
+	target text, a stream_matcher instead "flattens" the machine into a series
+	of "atoms" - each of which matches exactly ONE code point ('?', a character
+	class, or one code point of an exact match sequence) - and tracks the SET of
+	all atoms which could be next, as a bit vector: bit k is set if the target
+	so far can match the first k atoms, and each '*' simply allows the bit of
+	the atom following it to "stay" set while consuming any code point.
+
+	Apart from this, the semantics of matching with a stream_matcher are exactly
+	the same as those of matcher::match.
+
+	N.B. - like threaded_matcher, a stream_matcher does NOT refer to the machine
+	it is constructed from once constructed... BUT each match_state it starts
+	does refer to the stream_matcher, which must therefore outlive them.
+*/
+class match_state;
+class stream_matcher
+{
+	friend class match_state;
+
+	enum class kind : std::uint8_t { any, bits, range, exact, folded };
+
+	struct atom
+	{
+		kind k = kind::any;
+		bool invert = false;			// ("interpreted" class is inverted)
+		std::uint32_t at = 0, n = 0;	// (fast path bitset, or class members)
+		char32_t c = 0;					// (code point of an exact match - or folded)
+	};
+
+	std::vector<atom> atoms;			// flattened machine (m atoms)
+	std::vector<std::uint64_t> stars;	// bit k set => '*' before atom k (m+1)
+	std::vector<detail::classBits> bits;// bitsets of "fast path" classes
+	std::vector<std::pair<char32_t, char32_t>> ranges;// "interpreted" members
+
+	/*
+		load decodes the finite state machine in the specified Format into atoms
+		(and stars), copying all operands.
+	*/
+	template<class Format>
+	void load(const char* mi) {
+		std::vector<size_t> s;
+		const auto h = detail::decodeHeader<Format>(mi);
+		const auto last = h.last;
+		mi = h.first;
+		while (mi != last)
+			switch (*mi++) {
+			case '?':
+				atoms.push_back({ .k = kind::any });
+				break;
+			case '.':
+				// (the stream consumes code points one at a time anyway)
+				atoms.insert(atoms.end(), Format::decodeLength(mi), { .k = kind::any });
+				break;
+			case '*':
+				s.push_back(atoms.size());
+				break;
+			case '{': {
+				const auto bi = last + Format::decodeLength(mi) + 1;
+				detail::classBits b;
+				for (size_t c = 0; c < 128; c++)
+					if (Format::testBitset(bi, c))
+						b.flip(c);
+				atoms.push_back({ .k = kind::bits, .at = (std::uint32_t)bits.size() });
+				bits.push_back(b);
+				break;
+			}
+			case '[': {
+				auto ci = last + Format::decodeLength(mi) + 1;
+				const auto invert = Format::decodeModifier(ci++);
+				const auto n = Format::decodeLength(ci);
+				const auto at = ranges.size();
+				for (const auto next = ci + n; ci != next;)
+					if (*ci++ == '+') {
+						const auto c = Format::decodeCodePoint(ci);
+						ranges.emplace_back(c, c);
+					} else {
+						const auto c1 = Format::decodeCodePoint(ci), c2 = Format::decodeCodePoint(ci);
+						ranges.emplace_back(c1, c2);
+					}
+				atoms.push_back({ .k = kind::range, .invert = invert, .at = (std::uint32_t)at, .n = (std::uint32_t)(ranges.size() - at) });
+				break;
+			}
+			case '=':
+			case '~': {
+				const auto k = mi[-1] == '=' ? kind::exact : kind::folded;
+				const auto n = Format::decodeLength(mi);
+				const utf8iteratorBare first = mi, next = mi + n;
+				std::for_each(first, next, [&](char32_t c) { atoms.push_back({ .k = k, .c = c }); });
+				mi += n;
+				break;
+			}
+			}
+		stars.resize(atoms.size() / 64 + 1);
+		for (auto k : s)
+			stars[k >> 6] |= (std::uint64_t)1 << (k & 63);
+	}
+
+	bool accepts(const atom& a, char32_t c) const noexcept {
+		switch (a.k) {
+		case kind::any:
+			return true;
+		case kind::bits:
+			return isascii(c) && bits[a.at].test(c);
+		case kind::range:
+			return detail::inRanges(ranges.data() + a.at, ranges.data() + a.at + a.n, c) != a.invert;
+		case kind::exact:
+			return a.c == c;
+		case kind::folded:
+			return a.c == detail::foldASCII(c);
+		}
+		return false;
+	}
+
+public:
+	/*
+		As for matcher, the ONLY supported values for the stream_matcher
+		constructor are those returned from the compiler::machine function (in
+		either the text or binary form).
+	*/
+	stream_matcher() = delete;
+	stream_matcher(string_view m) {
+		switch (m.empty() ? '\0' : m.front()) {
+		case detail::binaryFormat::Header:
+			load<detail::binaryFormat>(m.data());
+			break;
+		case detail::textFormat::Header:
+			load<detail::textFormat>(m.data());
+			break;
+		default:
+			// (the "empty" pattern matches ONLY the empty target)
+			stars.resize(1);
+			break;
+		}
+	}
+
+	/*
+		start returns a new match_state, positioned at the start of a target.
+	*/
+	match_state start() const;
+};
+
+/*
+	The match_state class holds the progress of matching a single target with a
+	stream_matcher: each chunk of the target is passed in turn to feed, and the
+	final result is then obtained from finish... as in
+
+	auto s = sm.start();
+	while (s.feed(chunk) && ...next chunk...)
+		;
+	return s.finish();
+
+	Chunks may begin and end ANYWHERE - including in the middle of a code point,
+	whose leading bytes are then held over until the rest arrive.
+*/
+class match_state
+{
+	friend class stream_matcher;
+
+	const stream_matcher* sm;
+	std::vector<std::uint64_t> live;	// bit k set => first k atoms matched
+	std::vector<std::uint64_t> next;	// (scratch for step)
+	char pending[4]{};					// leading bytes of a split code point
+	size_t pended = 0;
+	bool certain = false;				// a match is CERTAIN, whatever follows
+
+	match_state(const stream_matcher* s) : sm(s), live(s->stars.size()), next(s->stars.size()) {
+		live[0] = 1, check();
+	}
+
+	bool test(size_t k) const noexcept { return (live[k >> 6] >> (k & 63) & 1) != 0; }
+
+	// (note if we can NEVER fail - i.e., if all atoms matched AND then a '*')
+	void check() noexcept {
+		const auto m = sm->atoms.size();
+		certain = test(m) && (sm->stars[m >> 6] >> (m & 63) & 1) != 0;
+	}
+
+	/*
+		step advances the set of live atoms by consuming the code point c: every
+		live atom which accepts c makes the NEXT atom live, while an atom stays
+		live if a '*' precedes it.
+	*/
+	void step(char32_t c) noexcept {
+		const auto m = sm->atoms.size();
+		for (size_t w = 0; w < live.size(); w++)
+			next[w] = live[w] & sm->stars[w];
+		for (size_t w = 0; w < live.size(); w++)
+			for (auto b = live[w]; b != 0; b &= b - 1)
+				if (const auto k = w * 64 + std::countr_zero(b); k < m && sm->accepts(sm->atoms[k], c))
+					next[(k + 1) >> 6] |= (std::uint64_t)1 << ((k + 1) & 63);
+		live.swap(next), check();
+	}
+
+	template<bool Validate>
+	bool feedWith(string_view chunk) {
+		// FIRST, complete any code point split across the previous chunk...
+		if (pended != 0) {
+			const auto need = detail::sizeOfUTF8CodePoint(pending[0]);
+			while (pended < need && pended < sizeof pending && !chunk.empty())
+				pending[pended++] = chunk.front(), chunk.remove_prefix(1);
+			if (pended < need)
+				return viable();
+			if (Validate && !detail::validateUTF8String(string_view(pending, need)))
+				throw std::invalid_argument("Target string is not valid UTF-8.");
+			if (pended = 0; !certain && viable())
+				step(*utf8iteratorBare(pending));
+		}
+		// ... THEN hold over any code point split across the NEXT chunk...
+		for (size_t k = 1; k <= std::min(chunk.size(), (size_t)3); k++)
+			if (const auto b = chunk[chunk.size() - k]; (b & 0xc0) != 0x80) {
+				if (detail::sizeOfUTF8CodePoint(b) > k)
+					pended = k, std::copy_n(chunk.end() - k, k, pending), chunk.remove_suffix(k);
+				break;
+			}
+		// ... and FINALLY, consume all of the [complete] code points in between
+		if (Validate && !detail::validateUTF8String(chunk))
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		for (utf8iterator ti = chunk.cbegin(), end = chunk.cend(); ti != end && !certain && viable(); ++ti)
+			step(*ti);
+		return viable();
+	}
+
+public:
+	/*
+		feed consumes the next chunk of the [UTF-8] target, returning whether the
+		target CAN still match (i.e., false means a match is no longer possible,
+		and there is no point in feeding any more chunks).
+
+		invalid_argument if the chunk is NOT valid UTF-8 (after which the state
+		of matching is undefined)
+	*/
+	bool feed(string_view chunk) { return feedWith<true>(chunk); }
+
+	/*
+		feed (with the trusted_utf8 tag) is identical to the above, but without
+		any validation of the chunk, which MUST be [part of a] valid UTF-8 [target].
+	*/
+	bool feed(trusted_utf8_t, string_view chunk) { return feedWith<false>(chunk); }
+
+	/*
+		viable returns whether the target fed so far could still match, given the
+		right subsequent chunks.
+	*/
+	bool viable() const noexcept { return std::any_of(live.begin(), live.end(), [](auto w) { return w != 0; }); }
+
+	/*
+		finish returns whether the target fed so far - as a whole - matches.
+
+		invalid_argument if the target ends in the middle of a code point
+	*/
+	bool finish() const {
+		if (pended != 0)
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		return test(sm->atoms.size());
+	}
+};
+
+inline match_state stream_matcher::start() const { return match_state(this); }
+
+/*
+	The glob class is a "glue" class that composes a compiler and a matcher for
+	specifying and subsequently recognizing "glob" -style patterns over text in
+	UTF-8 form.
+
+	While certain specialized applications may find it convenient to separately
+	compile and match patterns - and will thus directly make use of the compiler
+	and matcher classes, the expected typical usage is to use the composed class
+	glob to handle all compiling, matching, and pretty-printing functionality.
+
+	Note that when using glob, there is no need to refer to or use the compiler
+	or matcher classes (or their constructors) at all: just create a glob object
+	and invoke its compile and match (or pretty_print) functions directly.
+
+	N.B. - since nobody is expected to ever read glob's compiled machines other
+	than the matcher itself, glob::compile defaults to the [faster] binary form.
+
+	The matcher "half" of a glob only ever holds a VIEW of the machine owned by
+	its compiler "half", so glob takes care to re-point it at that machine each
+	time it changes - i.e., after every [successful] compile, copy, or move.
+
+	As with compiler, glob is an alias for basic_glob with the standard allocator
+	(see pmr::glob, below, for use with a std::pmr::memory_resource).
+*/
+template<class Allocator = std::allocator<char>>
+class basic_glob : public basic_compiler<Allocator>, public matcher
+{
+	using compiler_type = basic_compiler<Allocator>;
+
+	void rebind() noexcept { matcher::operator=(matcher(compiler_type::machine())); }
+
+public:
+	basic_glob() : compiler_type(), matcher(compiler_type::machine()) {}
+	explicit basic_glob(const Allocator& a) : compiler_type(a), matcher(compiler_type::machine()) {}
+	basic_glob(string_view pattern, unsigned opts = binary, const Allocator& a = Allocator()) : basic_glob(a) { compile(pattern, opts); }
+	basic_glob(const basic_glob& g) : compiler_type(g), matcher(compiler_type::machine()) {}
+	basic_glob(basic_glob&& g) noexcept : compiler_type(std::move(g)), matcher(compiler_type::machine()) { g.rebind(); }
+	basic_glob& operator=(const basic_glob& g) { compiler_type::operator=(g); rebind(); return *this; }
+	basic_glob& operator=(basic_glob&& g) noexcept(std::allocator_traits<Allocator>::is_always_equal::value) { compiler_type::operator=(std::move(g)); rebind(), g.rebind(); return *this; }
+
+	void compile(string_view pattern, unsigned opts = binary) { compiler_type::compile(pattern, opts), rebind(); }
+};
+
+using glob = basic_glob<>;
+
+/*
+	The rglob::pmr namespace contains the compiler and glob classes compiled into
+	a std::pmr::memory_resource (e.g., a std::pmr::monotonic_buffer_resource),
+	much like the std::pmr containers.
+*/
+namespace pmr {
+	using compiler = basic_compiler<std::pmr::polymorphic_allocator<char>>;
+	using glob = basic_glob<std::pmr::polymorphic_allocator<char>>;
+}
+
+namespace detail {
+	/*
+		fixedString holds the text of a string literal in a form that allows it to
+		be used as a template argument (as in static_glob<"*.json">, below).
+	*/
+	template<size_t N>
+	struct fixedString
+	{
+		char s[N]{};
+
+		constexpr fixedString(const char (&v)[N]) { std::copy_n(v, N, s); }
+		constexpr string_view view() const noexcept { return { s, N - 1 }; }
+	};
+
+	/*
+		staticOp describes a single op in a machine that was compiled at compile
+		time: the op itself, plus the position (at) and length (n) of its operand
+		- if it has one.
+	*/
+	struct staticOp
+	{
+		char op = 0;
+		size_t at = 0, n = 0;
+		bool invert = false;
+	};
+}
+
+/*
+	The static_glob class template compiles its pattern - supplied as a string
+	literal template argument - at COMPILE time (so that a malformed pattern is
+	a compile error, rather than an invalid_argument exception at run time), and
+	ALSO specializes its matching logic for that pattern.
+
+	Where the matcher class "interprets" a machine one op at a time, the match
+	function of a static_glob is instantiated from a series of templates, one
+	for each op of the machine [known at compile time], so there is NO op decode
+	or dispatch at all when matching: exact match sequences become comparisons
+	with string constants, "fast path" character classes become tests against
+	constant bitsets, etc.
+
+	Apart from this, the semantics of static_glob::match are exactly the same as
+	those of matcher::match - e.g.,
+
+	static_glob<"*.json">::match("a.json")
+
+	... or equivalently, using the user-defined literal from rglob::literals,
+
+	("*.json"_glob).match("a.json")
+*/
+template<detail::fixedString Pattern>
+class static_glob
+{
+	// (N.B. - compile from a local COPY of the pattern, since some compilers
+	// will not constant-evaluate pointer tests against the template parameter
+	// object itself)
+	static constexpr size_t size = [] {
+		compiler c;
+		auto pattern = Pattern;
+		c.compile(pattern.view());
+		return c.machine().size();
+	}();
+	// (the compiled machine, in the text form - which is easier to decode)
+	static constexpr auto fsm = [] {
+		compiler c;
+		auto pattern = Pattern;
+		c.compile(pattern.view());
+		std::array<char, size> v{};
+		std::copy_n(c.machine().data(), size, v.data());
+		return v;
+	}();
+
+	// (local fn to visit each op in the machine in turn, with its operand info)
+	template<class F>
+	static constexpr void visit(F f) {
+		using Format = detail::textFormat;
+		if (size == 0)
+			return;
+		const auto h = detail::decodeHeader<Format>(fsm.data());
+		const auto last = h.last;
+		for (auto mi = h.first; mi != last;)
+			switch (detail::staticOp o{ *mi++ }; o.op) {
+			case '{':
+				o.at = (last - fsm.data()) + Format::decodeLength(mi) + 1, f(o);
+				break;
+			case '[': {
+				auto ci = last + Format::decodeLength(mi) + 1;
+				o.invert = Format::decodeModifier(ci++), o.n = Format::decodeLength(ci);
+				o.at = ci - fsm.data(), f(o);
+				break;
+			}
+			case '=':
+				o.n = Format::decodeLength(mi), o.at = mi - fsm.data(), mi += o.n, f(o);
+				break;
+			case '.':
+				o.n = Format::decodeLength(mi), f(o);
+				break;
+			default:
+				f(o);
+			}
+	}
+	static constexpr size_t count = [] {
+		size_t n = 0;
+		visit([&](detail::staticOp) { n++; });
+		return n;
+	}();
+	static constexpr auto ops = [] {
+		std::array<detail::staticOp, count> v{};
+		size_t i = 0;
+		visit([&](detail::staticOp o) { v[i++] = o; });
+		return v;
+	}();
+	static constexpr size_t nextStar(size_t i) {
+		while (i < count && ops[i].op != '*')
+			i++;
+		return i;
+	}
+	static constexpr size_t skipStars(size_t i) {
+		while (i < count && ops[i].op == '*')
+			i++;
+		return i;
+	}
+
+	// (the decoded operands of "fast path" and "interpreted" character classes)
+	template<size_t I>
+	static constexpr auto bits = detail::textFormat::decodeBitset(fsm.data() + ops[I].at);
+	template<size_t I>
+	static constexpr detail::classTable table{ bits<I> };
+	template<size_t I>
+	static constexpr size_t members = [] {
+		size_t n = 0;
+		for (auto mi = fsm.data() + ops[I].at, last = mi + ops[I].n; mi != last; n++)
+			for (auto k = *mi++ == '+' ? 1 : 2; k > 0; k--)
+				detail::textFormat::decodeCodePoint(mi);
+		return n;
+	}();
+	template<size_t I>
+	static constexpr auto ranges = [] {
+		std::array<std::pair<char32_t, char32_t>, members<I>> v{};
+		auto i = v.begin();
+		for (auto mi = fsm.data() + ops[I].at, last = mi + ops[I].n; mi != last; ++i) {
+			const auto single = *mi++ == '+';
+			i->first = detail::textFormat::decodeCodePoint(mi);
+			i->second = single ? i->first : detail::textFormat::decodeCodePoint(mi);
+		}
+		return v;
+	}();
+
+	static constexpr const char* next(const char* p) noexcept { return p + detail::sizeOfUTF8CodePoint(*p); }
+
+	/*
+		segment matches the ops [I, J) - which contain NO '*' ops - at p, advancing
+		p past the matched target text if successful.
+	*/
+	template<size_t I, size_t J>
+	static constexpr bool segment(const char*& p, const char* e) {
+		if constexpr (I == J)
+			return true;
+		else {
+			constexpr auto o = ops[I];
+			if constexpr (o.op == '=') {
+				constexpr string_view v(fsm.data() + o.at, o.n);
+				if ((size_t)(e - p) < v.size() || string_view(p, v.size()) != v)
+					return false;
+				p += v.size();
+			} else if constexpr (o.op == '.') {
+				for (auto n = o.n; n != 0; n--, p = next(p))
+					if (p == e)
+						return false;
+			} else {
+				if (p == e)
+					return false;
+				if constexpr (o.op == '{') {
+					if (const auto c = (unsigned char)*p; c >= 128 || !bits<I>.test(c))
+						return false;
+					++p;
+				} else if constexpr (o.op == '[') {
+					const auto c = *utf8iteratorBare(p);
+					const auto in = detail::inRanges(ranges<I>.begin(), ranges<I>.end(), c);
+					if (in == o.invert)
+						return false;
+					p = next(p);
+				} else
+					p = next(p);
+			}
+			return segment<I + 1, J>(p, e);
+		}
+	}
+
+	/*
+		from matches the ops from I to the end of the machine at p, where I is
+		either the first op of a segment, or a '*'... in the latter case, it tries
+		successive target positions for the segment that follows, until one works
+		- as in matcher::matchWith, only the most recent '*' is ever "retried".
+	*/
+	template<size_t I>
+	static constexpr bool from(const char* p, const char* e) {
+		if constexpr (I == count)
+			return p == e;
+		else if constexpr (ops[I].op != '*') {
+			constexpr auto J = nextStar(I);
+			return segment<I, J>(p, e) && from<J>(p, e);
+		} else {
+			constexpr auto K = skipStars(I);
+			if constexpr (K == count)
+				return true;
+			else {
+				constexpr auto J = nextStar(K);
+				for (const string_view t(p, e - p);;) {
+					if constexpr (ops[K].op == '=') {
+						// (find the leftmost place where this segment CAN start)
+						const auto i = detail::findString(t, string_view(fsm.data() + ops[K].at, ops[K].n), p - t.data());
+						if (i == string::npos)
+							return false;
+						p = t.data() + i;
+					} else if constexpr (ops[K].op == '{') {
+						// (... OR scan for a "fast path" class - see matcher::matchWith)
+						if (!std::is_constant_evaluated()) {
+							if (const auto i = detail::findInClass(p, e - p, table<K>); i == (size_t)(e - p))
+								return false;
+							else
+								p += i;
+						}
+					}
+					if (auto q = p; segment<K, J>(q, e)) {
+						if constexpr (J != count)
+							return from<J>(q, e);
+						else if (q == e)
+							return true;
+					}
+					if (p == e)
+						return false;
+					p = next(p);
+				}
+			}
+		}
+	}
+
+public:
+	/*
+		match accepts a [UTF-8] "target" string and attempts to match it to the
+		pattern, reflecting the match success/failure as its return value.
+
+		invalid_argument if the target string is NOT valid UTF-8
+	*/
+	static constexpr bool match(string_view target) {
+		// make SURE target is *structurally* valid UTF8
+		if (!detail::validateUTF8String(target))
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		return match(trusted_utf8, target);
+	}
+	static constexpr bool match(trusted_utf8_t, string_view target) {
+		if constexpr (size != 0)
+			if (constexpr auto h = detail::decodeHeader<detail::textFormat>(fsm.data()); target.size() < h.least || target.size() > h.most)
+				return false;
+		return from<0>(target.data(), target.data() + target.size());
+	}
+
+	/*
+		machine returns the [text form of the] compiled pattern, while pretty_print
+		displays it as would matcher::pretty_print.
+	*/
+	static constexpr string_view machine() noexcept { return { fsm.data(), size }; }
+	static void pretty_print(std::ostream& s, string_view pre = "") { matcher(machine()).pretty_print(s, pre); }
+};
+
+/*
+	The rglob::literals namespace supplies the _glob user-defined literal, which
+	produces a static_glob for the [string literal] pattern it is applied to.
+*/
+namespace literals {
+	template<detail::fixedString Pattern>
+	constexpr auto operator""_glob() noexcept { return static_glob<Pattern>{}; }
+}
+
+/*
+	The glob_set class compiles any number of patterns - each identified by its
+	[zero-based] position in the sequence of patterns supplied at construction
+	- for matching as a group against a target, finding ALL of the patterns the
+	target matches in one operation.
+
+	Rather than simply trying each pattern in turn, the longest "exact match"
+	sequence from each one (see matcher::literal) is entered into a single Aho-
+	Corasick automaton, so that one pass over the target yields the [typically
+	small] set of "candidate" patterns whose literals actually appear in it...
+	and only these candidates - along with any patterns having no literals at
+	all - are then fully matched.
+
+	Once constructed, a glob_set is immutable, and may be freely shared (for
+	matching) across threads.
+*/
+class glob_set
+{
+	// (an Aho-Corasick automaton "node", i.e., a prefix of one or more literals)
+	struct node {
+		std::uint32_t fail = 0;				// longest proper suffix also in trie
+		std::uint32_t dict = 0;				// next suffix w/ pattern ids (or root)
+		std::uint32_t edge = 0, edges = 0;	// [first, count) of edges (sorted)
+		std::uint32_t id = 0, ids = 0;		// [first, count) of pattern ids
+	};
+	struct edge {
+		unsigned char c;
+		std::uint32_t next;
+	};
+
+	std::vector<glob> globs;				// compiled patterns, in "id" order
+	std::vector<node> nodes;				// automaton nodes (nodes[0] is root)
+	std::vector<edge> edges;				// automaton edges, grouped by node
+	std::vector<std::uint32_t> ids;			// pattern ids, grouped by node
+	std::vector<std::uint32_t> always;		// ids of patterns WITHOUT literals
+	std::array<std::uint32_t, 256> root{};	// [dense] edges from root node
+	std::uint64_t serial = [] {				// (identifies the automaton, see marks)
+		static std::atomic<std::uint64_t> n{ 0 };
+		return ++n;
+	}();
+
+	// (the nodes visited by a match, as those marked with the CURRENT stamp -
+	// kept per thread, and only reset when that thread changes glob_sets)
+	struct marks {
+		std::uint64_t serial = 0;
+		std::uint32_t stamp = 0;
+		std::vector<std::uint32_t> at;
+	};
+	marks& visited() const {
+		static thread_local marks m;
+		if (m.serial != serial || m.at.size() != nodes.size() || ++m.stamp == 0)
+			m.serial = serial, m.stamp = 1, m.at.assign(nodes.size(), 0);
+		return m;
+	}
+
+	std::uint32_t edgeFrom(const node& n, unsigned char c) const noexcept {
+		const auto first = edges.cbegin() + n.edge, last = first + n.edges;
+		const auto i = std::lower_bound(first, last, c, [](const edge& e, unsigned char x) { return e.c < x; });
+		return i != last && i->c == c ? i->next : 0;
+	}
+	std::uint32_t step(std::uint32_t s, unsigned char c) const noexcept {
+		for (;; s = nodes[s].fail)
+			if (s == 0)
+				return root[c];
+			else if (const auto t = edgeFrom(nodes[s], c); t != 0)
+				return t;
+	}
+
+	/*
+		build constructs the automaton from the literals of the compiled patterns:
+		first as a simple trie (with per-node edge lists), then "flattened", and
+		finally with "fail" and "dict" links computed in breadth-first order.
+	*/
+	void build() {
+		std::vector<std::vector<edge>> trie(1);
+		std::vector<std::vector<std::uint32_t>> found(1);
+		for (std::uint32_t id = 0; id < globs.size(); id++) {
+			const auto v = globs[id].literal();
+			if (v.empty()) {
+				always.push_back(id);
+				continue;
+			}
+			std::uint32_t s = 0;
+			for (const unsigned char c : v) {
+				auto i = std::find_if(trie[s].begin(), trie[s].end(), [=](const edge& e) { return e.c == c; });
+				if (i == trie[s].end()) {
+					trie[s].push_back({ c, (std::uint32_t)trie.size() });
+					trie.emplace_back(), found.emplace_back();
+					i = trie[s].end() - 1;
+				}
+				s = i->next;
+			}
+			found[s].push_back(id);
+		}
+		nodes.resize(trie.size());
+		for (size_t s = 0; s < trie.size(); s++) {
+			auto& t = trie[s];
+			std::sort(t.begin(), t.end(), [](const edge& a, const edge& b) { return a.c < b.c; });
+			nodes[s].edge = (std::uint32_t)edges.size(), nodes[s].edges = (std::uint32_t)t.size();
+			edges.insert(edges.end(), t.begin(), t.end());
+			nodes[s].id = (std::uint32_t)ids.size(), nodes[s].ids = (std::uint32_t)found[s].size();
+			ids.insert(ids.end(), found[s].begin(), found[s].end());
+		}
+		for (const auto& e : trie[0])
+			root[e.c] = e.next;
+		// (breadth-first, so that "fail" links always refer to shallower nodes)
+		std::vector<std::uint32_t> queue(trie[0].size());
+		std::transform(trie[0].begin(), trie[0].end(), queue.begin(), [](const edge& e) { return e.next; });
+		for (size_t q = 0; q < queue.size(); q++)
+			for (const auto u = queue[q]; const auto& e : trie[u]) {
+				const auto f = step(nodes[u].fail, e.c);
+				nodes[e.next].fail = f;
+				nodes[e.next].dict = nodes[f].ids != 0 ? f : nodes[f].dict;
+				queue.push_back(e.next);
+			}
+	}
+
+public:
+	/*
+		Construct a glob_set from the supplied patterns, compiling each of them
+		(see compiler::compile for the exceptions that may be thrown).
+	*/
+	template<std::ranges::input_range R>
+		requires std::convertible_to<std::ranges::range_reference_t<R>, string_view>
+	explicit glob_set(const R& patterns, unsigned opts = binary) {
+		for (const auto& p : patterns)
+			globs.emplace_back(p, opts);
+		build();
+	}
+	glob_set(std::initializer_list<string_view> patterns, unsigned opts = binary) : glob_set(std::span(patterns.begin(), patterns.size()), opts) {}
+
+	/*
+		size returns the number of patterns, while operator[] returns the glob
+		compiled from the pattern with the supplied id.
+	*/
+	size_t size() const noexcept { return globs.size(); }
+	const glob& operator[](size_t id) const noexcept { return globs[id]; }
+
+	/*
+		match accepts a [UTF-8] "target" string and matches it against ALL of the
+		patterns in the set, storing the ids of those which match it into the
+		supplied vector, in ascending order (and also returning this vector).
+
+		invalid_argument if the target string is NOT valid UTF-8
+	*/
+	std::vector<size_t>& match(string_view target, std::vector<size_t>& matched) const {
+		// make SURE target is *structurally* valid UTF8
+		if (!detail::validateUTF8String(target))
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		return match(trusted_utf8, target, matched);
+	}
+	std::vector<size_t> match(string_view target) const {
+		std::vector<size_t> matched;
+		match(target, matched);
+		return matched;
+	}
+
+	/*
+		match (with the trusted_utf8 tag) is identical to the above, but without
+		any validation of the target string, which MUST already be known to be
+		valid UTF-8.
+	*/
+	std::vector<size_t>& match(trusted_utf8_t, string_view target, std::vector<size_t>& matched) const {
+		matched.clear();
+		// FIRST, collect the [distinct] nodes with ids reached by running the
+		// automaton - where reaching an ALREADY visited node means the rest of
+		// its chain of suffixes has been collected, too...
+		auto& m = visited();
+		std::uint32_t s = 0;
+		for (const unsigned char c : target)
+			for (auto o = nodes[s = step(s, c)].ids != 0 ? s : nodes[s].dict; o != 0 && m.at[o] != m.stamp; o = nodes[o].dict)
+				m.at[o] = m.stamp, matched.push_back(o);
+		// ... THEN replace them with the candidate pattern ids they identify...
+		const auto n = matched.size();
+		for (size_t i = 0; i < n; i++) {
+			const auto& x = nodes[matched[i]];
+			matched.insert(matched.end(), ids.begin() + x.id, ids.begin() + x.id + x.ids);
+		}
+		matched.erase(matched.begin(), matched.begin() + n);
+		matched.insert(matched.end(), always.begin(), always.end());
+		std::sort(matched.begin(), matched.end());
+		// ... and FINALLY, keep only those candidates that actually match
+		matched.erase(std::remove_if(matched.begin(), matched.end(), [&](size_t id) { return !globs[id].match(trusted_utf8, target); }), matched.end());
+		return matched;
+	}
+};
+
+/*
+	The path_glob class compiles a pattern for matching [filesystem or object
+	store] PATHS, i.e., sequences of segments separated by '/': the pattern is
+	split into segments of its own - each compiled separately - so that within
+	any one segment "*" (and "?", and classes) can NOT match a '/', while a
+	segment of JUST "**" matches any number (including none) of whole segments.
+
+	Besides matching complete paths, the set of pattern segments a path could
+	still be "at" can be carried from one path segment to the next - see start
+	and enter - and a directory walker can then skip [prune] the whole subtree
+	below a directory as soon as viable reports no path within it can match.
+
+	N.B. - a '/' in the pattern ALWAYS separates segments (even inside of what
+	would otherwise be a character class), and empty segments (from leading,
+	trailing, or repeated '/'s) are matched like any others.
+
+	Like glob_set, a path_glob is immutable once constructed, and may be freely
+	shared (for matching) across threads.
+*/
+class path_glob
+{
+	std::vector<glob> segments;				// compiled segments, in path order
+	std::uint64_t globstars = 0;			// segments that are "**" (as bits)
+
+	// (add the positions after any "**", which may match NO segments at all)
+	std::uint64_t closure(std::uint64_t s) const noexcept {
+		for (size_t i = 0; i < segments.size(); i++)
+			if ((s >> i & 1) != 0 && (globstars >> i & 1) != 0)
+				s |= std::uint64_t(1) << (i + 1);
+		return s;
+	}
+
+public:
+	/*
+		A state is the set of pattern positions a path matched so far could be at,
+		with bit i set for "segment i is next", and bit size() for "all matched".
+	*/
+	using state = std::uint64_t;
+
+	/*
+		Construct a path_glob from the supplied pattern, compiling each of its
+		segments (see compiler::compile for the exceptions that may be thrown).
+
+		length_error if the pattern has more than 63 segments
+	*/
+	explicit path_glob(string_view pattern, unsigned opts = binary) {
+		for (size_t o = 0;;) {
+			const auto e = std::min(pattern.find('/', o), pattern.size());
+			if (segments.size() == 63)
+				throw std::length_error("Exceeded allowed number of path segments.");
+			const auto v = pattern.substr(o, e - o);
+			if (v == "**")
+				globstars |= std::uint64_t(1) << segments.size();
+			segments.emplace_back(v, opts);
+			if (e == pattern.size())
+				break;
+			o = e + 1;
+		}
+	}
+
+	/*
+		size returns the number of pattern segments, while operator[] returns the
+		glob compiled from the segment at the supplied position.
+	*/
+	size_t size() const noexcept { return segments.size(); }
+	const glob& operator[](size_t i) const noexcept { return segments[i]; }
+
+	/*
+		start returns the state before ANY path segments, while enter returns the
+		state after the supplied [UTF-8] path segment (which must NOT contain '/').
+
+		invalid_argument if the path segment is NOT valid UTF-8
+	*/
+	state start() const noexcept { return closure(1); }
+	state enter(state s, string_view segment) const {
+		// make SURE segment is *structurally* valid UTF8
+		if (!detail::validateUTF8String(segment))
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		return enter(trusted_utf8, s, segment);
+	}
+	state enter(trusted_utf8_t, state s, string_view segment) const {
+		state t = 0;
+		for (size_t i = 0; i < segments.size(); i++)
+			if ((s >> i & 1) == 0)
+				continue;
+			else if ((globstars >> i & 1) != 0)
+				t |= std::uint64_t(1) << i;
+			else if (segments[i].match(trusted_utf8, segment))
+				t |= std::uint64_t(1) << (i + 1);
+		return closure(t);
+	}
+
+	/*
+		viable returns whether any path continuing [with more segments] from the
+		state could still match, while matched returns whether the path as it is
+		DOES match.
+	*/
+	bool viable(state s) const noexcept { return (s & ((std::uint64_t(1) << segments.size()) - 1)) != 0; }
+	bool matched(state s) const noexcept { return (s >> segments.size() & 1) != 0; }
+
+	/*
+		match accepts a [UTF-8] "target" path and attempts to match it to the
+		pattern, segment by segment, reflecting the match success/failure as its
+		return value.
+
+		invalid_argument if the target string is NOT valid UTF-8
+	*/
+	bool match(string_view target) const {
+		// make SURE target is *structurally* valid UTF8
+		if (!detail::validateUTF8String(target))
+			throw std::invalid_argument("Target string is not valid UTF-8.");
+		return match(trusted_utf8, target);
+	}
+
+	/*
+		match (with the trusted_utf8 tag) is identical to the above, but without
+		any validation of the target string, which MUST already be known to be
+		valid UTF-8.
+	*/
+	bool match(trusted_utf8_t, string_view target) const {
+		auto s = start();
+		for (size_t o = 0;;) {
+			const auto e = std::min(target.find('/', o), target.size());
+			if ((s = enter(trusted_utf8, s, target.substr(o, e - o))) == 0)
+				return false;	// (no pattern position left, so no need to go on)
+			if (e == target.size())
+				return matched(s);
+			o = e + 1;
+		}
+	}
+};
+
+/*
+	The glob_cache class is a thread-safe, bounded cache of compiled patterns,
+	for uses that "see" the same [relatively few] patterns over and over - e.g.,
+	from user queries - and would otherwise validate and compile each of them
+	again every time: get returns the [shared, immutable] glob compiled from a
+	pattern, compiling it only if it is not already in the cache.
+
+	When the cache holds capacity patterns, the Least Recently Used is evicted
+	to make room for a new one... though any glob handed out from the cache of
+	course remains valid for as long as it is held by the caller.
+
+	N.B. - patterns are compiled OUTSIDE of the [internal] lock, so that a slow
+	compile never holds up other threads - the rare "losers" of a race to add
+	the same pattern simply discard their copy and share the "winner's".
+*/
+class glob_cache
+{
+	struct entry {
+		string pattern;
+		unsigned opts;
+		std::shared_ptr<const glob> g;
+	};
+	// (keys refer to the pattern text IN the entries, which never move)
+	struct key {
+		string_view pattern;
+		unsigned opts;
+		bool operator==(const key&) const = default;
+	};
+	struct hasher {
+		size_t operator()(const key& k) const noexcept { return std::hash<string_view>{}(k.pattern) ^ k.opts; }
+	};
+
+	mutable std::mutex lock;				// (guards ALL of the following)
+	size_t capacity;						// maximum number of cached patterns
+	std::list<entry> lru;					// cached patterns, most recent first
+	std::unordered_map<key, std::list<entry>::iterator, hasher> index;
+	size_t hit = 0, missed = 0;				// (counts of get calls)
+
+public:
+	explicit glob_cache(size_t capacity = 256) : capacity(std::max(capacity, (size_t)1)) {}
+	glob_cache(const glob_cache&) = delete;
+	glob_cache& operator=(const glob_cache&) = delete;
+
+	/*
+		get returns the glob compiled from the supplied pattern with the supplied
+		options (see compiler::compile for the exceptions that may be thrown, in
+		which case NOTHING is cached).
+	*/
+	std::shared_ptr<const glob> get(string_view pattern, unsigned opts = binary) {
+		{
+			std::lock_guard<std::mutex> l(lock);
+			if (const auto i = index.find({ pattern, opts }); i != index.end()) {
+				lru.splice(lru.begin(), lru, i->second);
+				return hit++, i->second->g;
+			}
+			missed++;
+		}
+		auto g = std::make_shared<const glob>(pattern, opts);
+		std::lock_guard<std::mutex> l(lock);
+		if (const auto i = index.find({ pattern, opts }); i != index.end()) {
+			lru.splice(lru.begin(), lru, i->second);
+			return i->second->g;
+		}
+		lru.push_front({ string(pattern), opts, std::move(g) });
+		index.emplace(key{ lru.front().pattern, opts }, lru.begin());
+		if (lru.size() > capacity)
+			index.erase({ lru.back().pattern, lru.back().opts }), lru.pop_back();
+		return lru.front().g;
+	}
+
+	/*
+		size returns the number of patterns currently cached, while hits and misses
+		return the number of get calls that did (and did NOT) find their pattern
+		already in the cache, and clear empties the cache (but NOT the counts).
+	*/
+	size_t size() const { std::lock_guard<std::mutex> l(lock); return lru.size(); }
+	size_t hits() const { std::lock_guard<std::mutex> l(lock); return hit; }
+	size_t misses() const { std::lock_guard<std::mutex> l(lock); return missed; }
+	void clear() { std::lock_guard<std::mutex> l(lock); index.clear(), lru.clear(); }
+};
+
+/*
+	parallel_filter matches EACH of a [large] collection of [UTF-8] targets
+	against the pattern of the supplied matcher (or threaded_matcher, or glob),
+	using up to threads threads (or one per hardware thread, if threads is 0),
+	and returns the indices of the targets that matched - in ascending order.
+
+	The targets are handed out to the threads in chunks of chunk targets (each
+	matched with match_many) through a single shared counter, so that threads
+	which happen to get "cheap" chunks simply go on to take more of them, and
+	the results for each chunk are then gathered in chunk order.
+
+	N.B. - this relies on matching being safe to perform concurrently, which is
+	true of ALL of the const member functions of matcher, threaded_matcher, and
+	glob_set: none of them modify ANY state... though for a glob, this of course
+	also requires that it NOT be [re-]compiled while being matched against.
+
+	invalid_argument if any of the targets is NOT valid UTF-8
+*/
+template<class Matcher>
+	requires requires(const Matcher& m, std::span<const string_view> t, std::span<std::uint8_t> r) { m.match_many(trusted_utf8, t, r); }
+std::vector<size_t> parallel_filter(const Matcher& m, std::span<const string_view> targets, unsigned threads = 0, size_t chunk = 4096)
+{
+	chunk = std::max(chunk, (size_t)1);
+	const auto chunks = (targets.size() + chunk - 1) / chunk;
+	if (threads == 0)
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	threads = (unsigned)std::min((size_t)threads, chunks);
+	std::vector<std::vector<size_t>> found(chunks);
+	std::atomic<size_t> next = 0;
+	std::atomic<bool> invalid = false;
+	std::exception_ptr failure;
+	std::mutex failureLock;
+	// (local fn to take - and match - chunks until there are none left)
+	auto work = [&] {
+		try {
+			std::vector<std::uint8_t> results(chunk);
+			for (size_t i; !invalid && (i = next++) < chunks;) {
+				const auto batch = targets.subspan(i * chunk, std::min(chunk, targets.size() - i * chunk));
+				if (find_invalid_utf8(batch) != batch.size()) {
+					invalid = true;
+					break;
+				}
+				m.match_many(trusted_utf8, batch, results);
+				for (size_t j = 0; j < batch.size(); j++)
+					if (results[j])
+						found[i].push_back(i * chunk + j);
+			}
+		} catch (...) {
+			const std::lock_guard lock(failureLock);
+			if (!failure)
+				failure = std::current_exception();
+			invalid = true;
+		}
+	};
+	{
+		// (the calling thread is one of the workers, and jthreads join for us)
+		std::vector<std::jthread> pool;
+		try {
+			for (unsigned t = 1; t < threads; t++)
+				pool.emplace_back(work);
+		} catch (...) {
+			invalid = true;
+			throw;
+		}
+		work();
+	}
+	if (failure)
+		std::rethrow_exception(failure);
+	if (invalid)
+		throw std::invalid_argument("Target string is not valid UTF-8.");
+	std::vector<size_t> v;
+	for (auto& f : found)
+		v.insert(v.end(), f.begin(), f.end());
+	return v;
+}
+
+namespace detail {
+	/*
+		scanLines performs the actual work of scan_lines and scan_file (below),
+		numbering lines from line, and reporting offsets from base.
+	*/
+	template<class Matcher, class F>
+	size_t scanLines(const Matcher& m, string_view buffer, size_t& line, size_t base, F& f)
+	{
+		// (validate the WHOLE buffer at once, only "falling back" to line by line)
+		const auto valid = validateUTF8String(buffer);
+		size_t found = 0;
+		for (size_t i = 0, j; i < buffer.size(); i = j + 1) {
+			j = i + findChar(buffer.data() + i, buffer.size() - i, '\n');
+			const auto v = buffer.substr(i, j - i);
+			++line;
+			if ((valid || validateUTF8String(v)) && m.match(trusted_utf8, v))
+				found++, f(line, base + i, v);
+		}
+		return found;
+	}
+
+#if defined(RGLOB_MMAP)
+	/*
+		fileMapping maps the WHOLE of a [regular, non-empty] file into memory, and
+		makes SURE it is unmapped and closed again, whatever happens meanwhile -
+		if the file can NOT be mapped, then view() is simply empty.
+
+		runtime_error if the file can NOT be opened
+	*/
+	class fileMapping
+	{
+		int fd;
+		void* p = MAP_FAILED;
+		size_t n = 0;
+
+	public:
+		explicit fileMapping(const string& path) : fd(::open(path.c_str(), O_RDONLY)) {
+			if (fd < 0)
+				throw std::runtime_error("Unable to open " + path + '.');
+			if (struct stat st; ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+				if (p = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0); p != MAP_FAILED)
+					n = (size_t)st.st_size;
+		}
+		fileMapping(const fileMapping&) = delete;
+		fileMapping& operator=(const fileMapping&) = delete;
+		~fileMapping() { if (p != MAP_FAILED) ::munmap(p, n); ::close(fd); }
+
+		string_view view() const noexcept { return p != MAP_FAILED ? string_view((const char*)p, n) : string_view(); }
+		void advise(int a) const noexcept { if (p != MAP_FAILED) ::madvise(p, n, a); }
+	};
+#endif
+
+	/*
+		readFile returns the entire contents of the file at path.
+
+		runtime_error if the file can NOT be opened or read
+	*/
+	inline string readFile(const string& path) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+			throw std::runtime_error("Unable to open " + path + '.');
+		string v;
+		for (char b[1 << 16]; in.read(b, sizeof b) || in.gcount() > 0;)
+			v.append(b, (size_t)in.gcount());
+		if (in.bad())
+			throw std::runtime_error("Unable to read " + path + '.');
+		return v;
+	}
+}
+
+/*
+	scan_lines matches EACH line of a [UTF-8] buffer against the pattern of the
+	supplied matcher (or threaded_matcher, or glob), calling
+
+	f(line, offset, text)
+
+	for each line that matches, with its line number (starting at 1), offset in
+	the buffer, and text - as a string_view into the buffer, i.e., with NO copy
+	of the line ever made - and then returns the number of lines that matched.
+
+	Lines end at a '\n' (which is NOT part of the line's text, though any '\r'
+	before it IS), or at the end of the buffer; the buffer is validated as UTF-8
+	as a whole, and any lines which are NOT valid UTF-8 simply do not match.
+*/
+template<class Matcher, class F>
+	requires requires(const Matcher& m, string_view t) { m.match(trusted_utf8, t); }
+size_t scan_lines(const Matcher& m, string_view buffer, F&& f)
+{
+	size_t line = 0;
+	return detail::scanLines(m, buffer, line, 0, f);
+}
+
+/*
+	scan_file is identical to scan_lines (above), but for the contents of the
+	file at path, where offset is then the offset within the file.
+
+	Where memory-mapped files are available (POSIX, unless RGLOB_NO_MMAP is
+	defined), the whole [regular] file is mapped into memory and scanned in
+	place; otherwise, it is read - and scanned - a block of lines at a time.
+
+	runtime_error if the file can NOT be opened or read
+*/
+template<class Matcher, class F>
+	requires requires(const Matcher& m, string_view t) { m.match(trusted_utf8, t); }
+size_t scan_file(const Matcher& m, const string& path, F&& f)
+{
+	size_t line = 0;
+#if defined(RGLOB_MMAP)
+	// (make SURE we unmap and close, whatever f may do)
+	if (const detail::fileMapping map(path); !map.view().empty())
+		return map.advise(MADV_SEQUENTIAL), detail::scanLines(m, map.view(), line, 0, f);
+	// (fall through to reading the file if it is empty - OR not mappable)
+#endif
+	std::ifstream in(path, std::ios::binary);
+	if (!in)
+		throw std::runtime_error("Unable to open " + path + '.');
+	constexpr size_t BlockSize = 1 << 20;
+	string buffer;
+	size_t found = 0, base = 0;
+	for (;;) {
+		// (append the next block to whatever "partial" line is left over...)
+		const auto o = buffer.size();
+		buffer.resize(o + BlockSize);
+		const auto n = (size_t)in.read(buffer.data() + o, BlockSize).gcount();
+		buffer.resize(o + n);
+		if (in.bad())
+			throw std::runtime_error("Unable to read " + path + '.');
+		if (n == 0)
+			break;
+		// (... and scan all of the COMPLETE lines, keeping the rest for later)
+		if (const auto i = string_view(buffer).rfind('\n'); i != string::npos) {
+			found += detail::scanLines(m, string_view(buffer).substr(0, i + 1), line, base, f);
+			buffer.erase(0, i + 1), base += i + 1;
+		}
+	}
+	return found + detail::scanLines(m, buffer, line, base, f);
+}
+
+/*
+	Compiled machines hold NO pointers - only lengths and offsets - so they are
+	already relocatable, and a whole set of them can be saved as a single byte
+	string ("image") and later used in place, without compiling ANY of them
+	again: make_image builds such an image (e.g., to be written to a file) and
+	image_view (or image_file) hands its machines back out as matchers.
+
+	An image is laid out as follows (all integers in the [native] byte order of
+	the machine that built it, which is what binary form machines use, too)
+
+	"rglobimg"	magic number (8 chars)
+	version		ImageVersion (uint32_t)
+	order		0x01020304 as written, to detect the byte order (uint32_t)
+	checksum	FNV-1a hash of ALL of the bytes which follow (uint32_t)
+	count		number of machines (uint32_t)
+	directory	count entries of [offset, size] of each machine (2 x uint64_t)
+	machines	the machines themselves, in directory order
+
+	N.B. - machine offsets are relative to the start of the image, and the
+	version changes whenever the layout of the machines themselves does (e.g.,
+	version 2 added the target length bounds to the machine header, and 3 the
+	'~' op of ignore_case).
+*/
+constexpr std::uint32_t ImageVersion = 3;
+
+namespace detail {
+	constexpr char ImageMagic[8] = { 'r', 'g', 'l', 'o', 'b', 'i', 'm', 'g' };
+	constexpr std::uint32_t ImageOrder = 0x01020304;
+	constexpr size_t ImageHeaderSize = sizeof ImageMagic + 4 * sizeof(std::uint32_t);
+	constexpr size_t ImageEntrySize = 2 * sizeof(std::uint64_t);
+
+	template<typename T>
+	inline T loadAt(string_view v, size_t i) noexcept { T x; std::memcpy(&x, v.data() + i, sizeof x); return x; }
+	template<typename T>
+	inline void storeAt(string& v, size_t i, T x) noexcept { std::memcpy(v.data() + i, &x, sizeof x); }
+
+	constexpr std::uint32_t fnv1a(string_view v) noexcept {
+		std::uint32_t h = 0x811c9dc5;
+		for (const unsigned char c : v)
+			h = (h ^ c) * 0x01000193;
+		return h;
+	}
+
+	/*
+		machineFits evaluates whether the [purported] machine m is at least laid
+		out as one - i.e., that its header and ops fit within it - in the Format.
+	*/
+	template<class Format>
+	inline bool machineFits(string_view m) noexcept {
+		if (m.size() < 1 + 3 * Format::LengthWidth)
+			return false;
+		auto p = m.data() + 1;
+		const auto n = Format::decodeLength(p);
+		Format::decodeLength(p), Format::decodeLength(p);
+		return (size_t)(p - m.data()) <= m.size() && n <= m.size() - (size_t)(p - m.data());
+	}
+}
+
+/*
+	make_image returns an image (see above) of the supplied machines - as returned
+	by compiler::machine - or of the machines of all of the patterns of a glob_set
+	(in id order).
+
+	length_error if the image would exceed the limits of the format
+*/
+inline string make_image(std::span<const string_view> machines)
+{
+	using namespace detail;
+	if (machines.size() > 0xffffffff)
+		throw std::length_error("Too many machines for image.");
+	string v(ImageHeaderSize + machines.size() * ImageEntrySize, '\0');
+	std::copy_n(ImageMagic, sizeof ImageMagic, v.data());
+	storeAt(v, 8, ImageVersion), storeAt(v, 12, ImageOrder), storeAt(v, 20, (std::uint32_t)machines.size());
+	for (size_t i = 0; i < machines.size(); i++) {
+		const auto e = ImageHeaderSize + i * ImageEntrySize;
+		storeAt(v, e, (std::uint64_t)v.size()), storeAt(v, e + sizeof(std::uint64_t), (std::uint64_t)machines[i].size());
+		v.append(machines[i]);
+	}
+	storeAt(v, 16, fnv1a(string_view(v).substr(20)));
+	return v;
+}
+inline string make_image(const glob_set& s)
+{
+	std::vector<string_view> v;
+	for (size_t i = 0; i < s.size(); i++)
+		v.push_back(s[i].machine());
+	return make_image(v);
+}
+
+/*
+	The image_view class accepts (via its constructor) an image produced by
+	make_image - which it does NOT own, and which must therefore outlive it (and
+	any matchers obtained from it) - and, once it has verified the image, hands
+	out its machines with machine(i), or ready-to-use matchers with operator[].
+
+	invalid_argument if the image is NOT well-formed, is from an incompatible
+	version (or byte order), or fails its checksum
+
+	N.B. - the checksum guards against damaged images... but matchers DO still
+	trust the machines within, so images must only ever come from make_image.
+*/
+class image_view
+{
+	string_view image;
+
+public:
+	explicit image_view(string_view v) : image(v) {
+		using namespace detail;
+		if (v.size() < ImageHeaderSize || !std::equal(ImageMagic, ImageMagic + sizeof ImageMagic, v.data()))
+			throw std::invalid_argument("Not an rglob image.");
+		if (loadAt<std::uint32_t>(v, 8) != ImageVersion || loadAt<std::uint32_t>(v, 12) != ImageOrder)
+			throw std::invalid_argument("Incompatible rglob image version or byte order.");
+		if (loadAt<std::uint32_t>(v, 16) != fnv1a(v.substr(20)))
+			throw std::invalid_argument("Checksum mismatch in rglob image.");
+		if ((v.size() - ImageHeaderSize) / ImageEntrySize < size())
+			throw std::invalid_argument("Truncated rglob image.");
+		for (size_t i = 0; i < size(); i++) {
+			const auto e = ImageHeaderSize + i * ImageEntrySize;
+			const auto o = loadAt<std::uint64_t>(v, e), n = loadAt<std::uint64_t>(v, e + sizeof(std::uint64_t));
+			if (o > v.size() || n > v.size() - o)
+				throw std::invalid_argument("Machine outside of rglob image.");
+			if (const auto m = v.substr(o, n); !(m.empty() || (m.front() == binaryFormat::Header ? machineFits<binaryFormat>(m) : m.front() == textFormat::Header && machineFits<textFormat>(m))))
+				throw std::invalid_argument("Malformed machine in rglob image.");
+		}
+	}
+
+	/*
+		size returns the number of machines in the image, machine returns the one
+		at index i (valid only as long as the image is), and operator[] returns a
+		matcher for it.
+	*/
+	size_t size() const noexcept { return detail::loadAt<std::uint32_t>(image, 20); }
+	string_view machine(size_t i) const noexcept {
+		const auto e = detail::ImageHeaderSize + i * detail::ImageEntrySize;
+		return image.substr(detail::loadAt<std::uint64_t>(image, e), detail::loadAt<std::uint64_t>(image, e + sizeof(std::uint64_t)));
+	}
+	matcher operator[](size_t i) const { return matcher(machine(i)); }
+};
+
+/*
+	The image_file class is an image_view of the image in the file at path...
+	which is memory-mapped where memory-mapped files are available (or else read
+	in whole)... N.B. - either way, the WHOLE image is read once on opening, as
+	image_view checksums it, and checks each of its machines.
+
+	runtime_error if the file can NOT be opened or read
+
+	invalid_argument if the file does NOT contain a valid image (see image_view)
+*/
+class image_file
+{
+#if defined(RGLOB_MMAP)
+	detail::fileMapping map;
+#endif
+	string contents;					// (iff NOT mapped)
+	image_view view;
+
+	string_view load(const string& path) {
+#if defined(RGLOB_MMAP)
+		if (!map.view().empty())
+			return map.view();
+#endif
+		return contents = detail::readFile(path);
+	}
+
+public:
+#if defined(RGLOB_MMAP)
+	explicit image_file(const string& path) : map(path), view(load(path)) {}
+#else
+	explicit image_file(const string& path) : view(load(path)) {}
+#endif
+	image_file(const image_file&) = delete;
+	image_file& operator=(const image_file&) = delete;
+
+	size_t size() const noexcept { return view.size(); }
+	string_view machine(size_t i) const noexcept { return view.machine(i); }
+	matcher operator[](size_t i) const { return view[i]; }
+};
+
+/*
+	The live_rules class template holds the CURRENT version of a set of compiled
+	rules - a glob_set by default, or e.g. an image_file - which any number of
+	threads may match against, while another thread replaces it with a new one
+	(say, after reloading the rules) with NO locking, or waiting, by the former.
+
+	A reader calls acquire, and matches against the snapshot returned for as
+	long as it likes: the rules it refers to remain valid until it is destroyed
+	(or released)... where acquiring and releasing is "wait-free", costing just
+	a few atomic ops on a counter [of one of several stripes, to limit contention
+	between readers] - and NEVER any allocation.
+
+	A writer calls replace, which constructs the new rules from its arguments -
+	BEFORE doing anything else, so that a slow compile holds up no one - then
+	publishes them for subsequent readers, and waits out a "grace period" (as
+	in RCU) for any readers still holding snapshots of the old rules, before
+	finally destroying them: readers count themselves in one of two "epochs",
+	and the writer flips between these TWICE, each time waiting for the readers
+	in the one no longer current to leave... after which none can remain who
+	acquired the old rules (which were no longer published by then).
+
+	N.B. - writers are serialized with each other (only), and a reader holding
+	onto a snapshot delays only the reclamation in replace; a live_rules must
+	of course outlive ALL snapshots acquired from it.
+*/
+template<class Rules = glob_set>
+class live_rules
+{
+	static constexpr size_t Stripes = 16;
+
+	// (a reader count, alone in its cache line)
+	struct alignas(64) counter {
+		std::atomic<size_t> n{ 0 };
+	};
+
+	std::atomic<const Rules*> current;		// rules published for readers
+	std::atomic<size_t> epoch{ 0 };			// [parity of] readers' epoch
+	mutable std::array<std::array<counter, Stripes>, 2> readers;
+	std::mutex writing;						// (serializes replace)
+
+	// (the stripe of this thread, fixed for its lifetime)
+	static size_t stripe() noexcept {
+		static thread_local const size_t s = std::hash<std::thread::id>{}(std::this_thread::get_id()) % Stripes;
+		return s;
+	}
+
+	// (wait for the readers counted in the epoch with parity e, if any, to leave)
+	void drain(size_t e) const noexcept {
+		for (auto& c : readers[e & 1])
+			while (c.n.load() != 0)
+				std::this_thread::yield();
+	}
+
+public:
+	/*
+		A snapshot refers to the rules current when it was acquired, which remain
+		valid until it is destroyed (or released).
+	*/
+	class snapshot
+	{
+		friend class live_rules;
+
+		const Rules* r;
+		counter* c;
+
+		snapshot(const Rules* r, counter* c) noexcept : r(r), c(c) {}
+
+	public:
+		snapshot(snapshot&& s) noexcept : r(std::exchange(s.r, nullptr)), c(std::exchange(s.c, nullptr)) {}
+		snapshot& operator=(snapshot&& s) noexcept {
+			if (this != &s)
+				release(), r = std::exchange(s.r, nullptr), c = std::exchange(s.c, nullptr);
+			return *this;
+		}
+		~snapshot() { release(); }
+
+		void release() noexcept {
+			if (c != nullptr)
+				c->n.fetch_sub(1), r = nullptr, c = nullptr;
+		}
+
+		const Rules& operator*() const noexcept { return *r; }
+		const Rules* operator->() const noexcept { return r; }
+	};
+
+	/*
+		Construct a live_rules with its initial rules constructed from the supplied
+		arguments (e.g., a glob_set, or the patterns for one).
+	*/
+	template<class... Args>
+	explicit live_rules(Args&&... args) : current(new Rules(std::forward<Args>(args)...)) {}
+	live_rules(const live_rules&) = delete;
+	live_rules& operator=(const live_rules&) = delete;
+	~live_rules() { delete current.load(); }
+
+	/*
+		acquire returns a snapshot of the current rules.
+	*/
+	snapshot acquire() const noexcept {
+		// (count ourselves in BEFORE loading the rules, see replace)
+		auto& c = readers[epoch.load() & 1][stripe()];
+		c.n.fetch_add(1);
+		return snapshot(current.load(), &c);
+	}
+
+	/*
+		replace constructs new rules from the supplied arguments, and makes them
+		the current ones - destroying the old rules once NO snapshot refers to
+		them (any exception from constructing the new ones leaves things as they
+		were).
+	*/
+	template<class... Args>
+	void replace(Args&&... args) {
+		std::unique_ptr<const Rules> next(new Rules(std::forward<Args>(args)...));
+		std::lock_guard<std::mutex> l(writing);
+		std::unique_ptr<const Rules> old(current.exchange(next.release()));
+		// (any reader that loaded the old rules was counted in BEFORE they were
+		// replaced above, in whichever epoch it saw - so wait out BOTH epochs)
+		for (auto k = 0; k < 2; k++)
+			drain(epoch.fetch_add(1));
+	}
 };
 
 }
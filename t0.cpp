@@ -1,10 +1,14 @@
 ﻿#include <iostream>
+#include <deque>
 #include "rglob.h"
 
 using namespace std;
 using namespace rglob;
 
 static void validate(string_view p, string_view t, bool x = true, bool pp = false);
+static void validateSet(const glob_set& s, string_view t, const vector<size_t>& x);
+template<detail::fixedString P>
+static void validateStatic(string_view t, bool x = true);
 
 /*
 	Both the main and validate functions below illustrate some sample patterns
@@ -23,6 +27,16 @@ int main(int argc, char* argv[])
 	validate("b", "BAD UTF-8 \xc0 ",false);	// (illegal 2nd char of UTF-8 seq)
 	validate("BAD UTF-8 \xf0", "c", false);	// ("\xf0" needs 4-char UTF-8 seq)
 
+	// ... including when the bad UTF-8 is buried in [vector-scanned] ASCII text
+	validate("*", string(70, 'x') + "\u20ac" + string(40, 'y'));
+	validate("*", string(70, 'x') + "\xe2\x82" + string(40, 'y'), false);
+	validate("*", string(33, 'x') + "\xff", false);
+
+	// ... and to do so in bulk, for a whole "batch" of targets at once
+	const string_view ts[] = { "a", "BAD UTF-8 \xc0 ", "c" };
+	const auto bad = find_invalid_utf8(ts);
+	cout << "Want 1, got " << bad << " (" << (bad != 1 ? "BZZZT!" : "OK") << ") with find_invalid_utf8" << endl;
+
 	// validate the simplest patterns...
 	validate("abc", "abc");
 	validate("abc", "abC", false);
@@ -30,11 +44,89 @@ int main(int argc, char* argv[])
 	validate("*bar", "foobar");
 	validate("*ba?", "foobaR", true, true);
 
+	// a '*' must be able to "give back" target text it was too quick to accept
+	validate("*a?c", "abaXc");
+	validate("*a?c", "aXac", false);
+	validate("*b", "bab");
+	validate("*ab?", "ababa");
+	validate("*a*a*a*a*a*a*b", string(200, 'a'), false);
+
+	// runs of wildcards are merged, and 1-member classes fused into literals
+	validate("a**?*?b", "aXYb", true, true);
+	validate("a**?*?b", "aXb", false);
+	validate("*???:??", "фф€:ф7");
+	validate("*???:??", "ф€:ф7", false);
+	validate("[a]b[c]*[ф]", "abcXф", true, true);
+	const glob ml("??[a-c].*[!]x]");
+	cout << "Want 5, got " << ml.min_length() << " (" << (ml.min_length() != 5 ? "BZZZT!" : "OK") << ") with min_length" << endl;
+
+	// patterns with NO '*' also bound how long a matching target can be
+	validate("[A-Z][0-9][0-9]-????", "X12-фф€ф", true, true);
+	validate("[A-Z][0-9][0-9]-????", "X12-" + string(17, 'a'), false);
+	validate("[A-Z][0-9][0-9]-????", "X12-abc", false);
+	const glob bl("[A-Z][0-9][0-9]-[ф-я]??");
+	const auto bb = to_string(bl.min_length()) + '-' + to_string(bl.max_length());
+	cout << "Want 8-14, got " << bb << " (" << (bb != "8-14" ? "BZZZT!" : "OK") << ") with max_length" << endl;
+
+	// anchored literals [and longer required ones] can reject targets up front
+	validate("/var/log/*", "/var/lo", false);
+	validate("ab*b", "ab", false);
+	validate("*.json", "a.jso", false);
+	validate("*[0-9]*error*?", "1 error!");
+	validate("*[0-9]*error*?", "1 erro!", false);
+	const glob js("/var/*error*.json");
+	const auto lit = string(js.prefix()) + '|' + string(js.suffix());
+	cout << "Want /var/|.json, got " << lit << " (" << (lit != "/var/|.json" ? "BZZZT!" : "OK") << ") with prefix/suffix" << endl;
+
+	// ... and how much work matching does can be counted (and "pinned" on ops)
+	const glob sg("x*error*[0-9]");
+	match_stats ms;
+	sg.match("x: error 42", ms), sg.match("no", ms), sg.match("x: fine", ms);
+	const auto rj = find_if(ms.rejected_at.begin(), ms.rejected_at.end(), [](size_t n) { return n != 0; }) - ms.rejected_at.begin();
+	const auto mx = ms.targets == 3 && ms.matched == 1 && ms.prefiltered == 1 && ms.ops['='] == 4 && sg.machine()[rj] == '=';
+	cout << "Want 3/1/1, got " << ms.targets << '/' << ms.matched << '/' << ms.prefiltered << " (" << (!mx ? "BZZZT!" : "OK") << ") with match_stats" << endl;
+
+	// ... and [vector-]search for literals after a '*' through many false starts
+	validate("*error*timeout*", string(100, 'e') + "error" + string(50, 't') + "timeout!");
+	validate("*error*timeout*", string(100, 'e') + "error" + string(50, 't') + "timeou", false);
+
+	// ALL-ASCII targets are matched byte-wise, others by code point (same results)
+	validate("*[!a-z]?.?", "abc-d.e");
+	validate("*[!a-z]?.?", "abc-ф.e");
+	validate("*[!a-z]?.?", "abcфd.e", false);
+
+	// ... and for "fast path" classes after a '*' in long [and Unicode] text
+	validate("*[0-9]?", string(100, 'x') + "ф€7ф");
+	validate("*[0-9]?", string(100, 'x') + "ф€ф7", false);
+
 	// ... now for some character classes
 	validate("[A-Z][0-9][^0-9]", "B2B", true, true);
 	validate("[A-Z][0-9][^0-9ф]", "B2Bx", false, true);
 	validate("[A-Z][0-9][^0-9]*", "B2Bx-ray");
 	validate("[A-Z][0-9][^0-9]", "B23", false);
+	validate("[^aф]", "a", false);
+	validate("[^aф]", "b");
+
+	// repeated and overlapping class members are simply [merged] members...
+	validate("[aa]", "a");
+	validate("[a-ca]", "b");
+	validate("[^aaф]", "a", false);
+	validate("[вa-cба-гa]", "б", true, true);
+	// ... while "backwards" ranges have none at all
+	validate("[я-аф]", "б", false);
+
+	// repeated classes share ONE [interned] body - but only if truly identical
+	validate("[A-Za-z_][A-Za-z0-9_]*[A-Za-z0-9_][ф-я]?[ф-я]", "x9_яыф", true, true);
+	validate("[a-c][!a-c]", "ab", false);
+	validate("[a-c][!a-c]", "ad");
+
+	// literals longer than 255 chars need BOTH digits of their [text] lengths
+	validate(string(300, 'x') + '*', string(300, 'x') + "yz");
+	validate(string(300, 'x') + '*', string(299, 'x') + "yz", false);
+
+	// ... and there is no longer a 4 KB limit on compiled patterns, either
+	validate(string(5000, 'x') + "*[\u0410-\u042F]", string(5000, 'x') + "yz\u0416");
+	validate(string(70000, 'x') + '?', string(70000, 'x') + "y");
 
 	// can you spot why this will throw an exception?
 	validate("[A-Z][0-9][^0-9*", "B2Bx-ray");
@@ -49,6 +141,134 @@ int main(int argc, char* argv[])
 	// (they really ARE the same pattern, see the pretty_print output yourself!)
 	validate("*[\u0410-\u042F \u0430-\u044F][\u0410-\u042F \u0430-\u044F][\u0410-\u042F \u0430-\u044F]bar\u03B5", "fu\u041f \u0444bar\u03B5", true, true);
 	validate("*[А-Я а-я][А-Я а-я][А-Я а-я]barε", "fuП фbarε", true, true);
+
+	// patterns can ALSO be compiled to match letters of either case (Unicode, too)
+	const glob ic("*.JSON[!a-c]ф*", binary | ignore_case);
+	const string_view it[] = { "A.json-Ф", "a.JsOnDфx", "a.jsonbф", "a.jsoN_Фx" };
+	compiler icc;
+	icc.compile("*.JSON[!a-c]ф*", ignore_case);
+	const stream_matcher ism(ic.machine());
+	string ir;
+	auto fx = true;
+	for (auto t : it) {
+		const auto r = ic.match(t);
+		ir += r ? '1' : '0';
+		auto is = ism.start();
+		is.feed(t);
+		fx &= matcher(icc.machine()).match(t) == r && threaded_matcher(ic.machine()).match(t) == r && is.finish() == r;
+	}
+	cout << "Want 1101, got " << ir << " (" << (!fx || ir != "1101" ? "BZZZT!" : "OK") << ") with ignore_case" << endl;
+	cout << "Pretty_print of *.JSON[!a-c]ф* (ignore_case):" << endl, ic.pretty_print(cout, "    ");
+
+	// finally, sets of patterns can ALL be matched against a target at once
+	const glob_set s{ "*error*", "*.json", "/var/log/*", "*[0-9]*", "abc", "*", "/var/*/error?json" };
+	validateSet(s, "/var/log/error.json", { 0, 1, 2, 5, 6 });
+	validateSet(s, "abc", { 4, 5 });
+	validateSet(s, "", { 5 });
+	const glob_set se{ "*e*", "*ee*", "*eee*", "*eeee*x", "*f*" };
+	validateSet(se, string(4096, 'e'), { 0, 1, 2 });
+
+	// ... and targets in UTF-16 (or UTF-32) can be matched with NO transcoding
+	const glob wg("*[ф-я]?.json");
+	const deque<char16_t> wd{ u'ф', 0xd83d, 0xde00, u'.', u'j', u's', u'o', u'n' };
+	const auto wx = wg.match(u"aф\U0001F600.json") && wg.match(U"aф\U0001F600.json") && wg.match(wd) && !wg.match(u"ф.json");
+	cout << "Want MATCH, got " << (wx ? "MATCH (OK)" : "FAIL! (BZZZT!)") << " with UTF-16/UTF-32 -> *[ф-я]?.json" << endl;
+
+	// ... and the text consumed by each run of wildcards can be captured, too
+	const string ct = "logs/2024/app-фф.gz";
+	match_span cs[2];
+	const auto cm = glob("logs/*/app-*.gz").match(ct, cs);
+	const auto cv = string(ct.substr(cs[0].offset, cs[0].length)) + ' ' + string(ct.substr(cs[1].offset, cs[1].length));
+	cout << "Want 2024 фф, got " << cv << " (" << (!cm || cv != "2024 фф" ? "BZZZT!" : "OK") << ") with match_span" << endl;
+
+	// ... while paths can be matched segment by segment, pruning whole subtrees
+	const path_glob pg("src/**/test_*.cpp");
+	const string_view pt[] = { "src/test_a.cpp", "src/a/b/test_b.cpp", "src/a/test_c.cpp/x", "src/test_/a.cpp", "lib/src/test_d.cpp" };
+	string gr;
+	for (auto t : pt)
+		gr += pg.match(t) ? '1' : '0';
+	const auto pk = pg.viable(pg.enter(pg.start(), "src")) && !pg.viable(pg.enter(pg.start(), "lib"));
+	cout << "Want 11000, got " << gr << " (" << (!pk || gr != "11000" ? "BZZZT!" : "OK") << ") with path_glob" << endl;
+
+	// ... and saved as an "image" of their machines, to be used without compiling
+	const auto img = make_image(s);
+	const image_view iv(img);
+	const auto ix = iv.size() == s.size() && iv[1].match("a.json") && !iv[4].match("abcd") && iv.machine(6) == s[6].machine();
+	cout << "Want 7, got " << iv.size() << " (" << (!ix ? "BZZZT!" : "OK") << ") with image_view" << endl;
+
+	// ... or one pattern can be matched against a whole batch of targets
+	const string_view bs[] = { "a.json", "b.txt", "", "ф.json", "json" };
+	uint8_t br[size(bs)], tr[size(bs)];
+	glob("*.json").match_many(bs, br);
+	threaded_matcher(glob("*.json").machine()).match_many(trusted_utf8, bs, tr);
+	const auto bx = br[0] && !br[1] && !br[2] && br[3] && !br[4] && equal(begin(br), end(br), tr);
+	cout << "Want 10010, got " << +br[0] << +br[1] << +br[2] << +br[3] << +br[4] << " (" << (!bx ? "BZZZT!" : "OK") << ") with match_many" << endl;
+
+	// ... and [large] batches can be split across threads, too
+	vector<string> ps;
+	for (int i = 0; i < 10000; i++)
+		ps.push_back("/var/log/app" + to_string(i) + (i % 3 ? ".json" : ".txt"));
+	const vector<string_view> pv(ps.begin(), ps.end());
+	const auto pr = parallel_filter(glob("/var/log/*[05].json"), pv, 4, 100);
+	const auto px = pr.size() == 1333 && is_sorted(pr.begin(), pr.end()) && all_of(pr.begin(), pr.end(), [&](size_t i) { return i % 5 == 0 && i % 3; });
+	cout << "Want 1333, got " << pr.size() << " (" << (!px ? "BZZZT!" : "OK") << ") with parallel_filter" << endl;
+
+	// ... and patterns seen over and over need only be compiled ONCE (or so)
+	glob_cache gc(2);
+	const auto g1 = gc.get("*.json"), g2 = gc.get("*.json");
+	gc.get("a*"), gc.get("b*"), gc.get("*.json");
+	const auto cx = g1 == g2 && g1->match("a.json") && gc.hits() == 1 && gc.misses() == 4 && gc.size() == 2;
+	cout << "Want 1/4, got " << gc.hits() << '/' << gc.misses() << " (" << (!cx ? "BZZZT!" : "OK") << ") with glob_cache" << endl;
+
+	// ... or compiled into a [fixed-size] arena, to be freed all at once
+	std::byte arena[1024];
+	std::pmr::monotonic_buffer_resource mr(arena, sizeof arena, std::pmr::null_memory_resource());
+	const rglob::pmr::glob ag("*[0-9].json", binary, &mr);
+	const auto ax = ag.match("a1.json") && !ag.match("a.json") && ag.get_allocator().resource() == &mr;
+	cout << "Want MATCH, got " << (ax ? "MATCH (OK)" : "FAIL! (BZZZT!)") << " with a1.json -> *[0-9].json in pmr arena" << endl;
+
+	// ... while targets that arrive in pieces can be matched piece by piece
+	const stream_matcher sm(glob("*[А-Я а-я]bar?").machine());
+	auto ss = sm.start();
+	const string st = "fuП фbarε";
+	for (auto c : st)
+		ss.feed(string_view(&c, 1));	// (N.B. - splits EVERY Unicode char!)
+	const stream_matcher sn(glob("fu?").machine());
+	auto sf = sn.start();
+	const auto sx = ss.finish() && sf.feed("fuП") && !sf.feed("x") && !sf.finish();	// (rejected EARLY)
+	cout << "Want MATCH, got " << (ss.finish() ? "MATCH" : "FAIL!") << " (" << (!sx ? "BZZZT!" : "OK") << ") with " << st << " -> stream_matcher" << endl;
+
+	// ... and whole buffers (or files) of text can be matched line by line
+	string sl;
+	const auto sc = scan_lines(glob("*error*"), "ok\nan error\n\xc0 error\nerrors\n", [&](size_t n, size_t o, string_view v) {
+		sl += to_string(n) + '@' + to_string(o) + ':' + string(v) + ' ';
+	});
+	cout << "Want 2@3:an error 4@20:errors, got " << sl << "(" << (sc != 2 || sl != "2@3:an error 4@20:errors " ? "BZZZT!" : "OK") << ") with scan_lines" << endl;
+
+	// ... and live rules can be replaced while other threads are matching with them
+	live_rules<> lr(glob_set{ "*.json" });
+	atomic<bool> ld = false, lb = false;
+	thread lt([&] {
+		while (!ld)
+			if (const auto r = lr.acquire(); r->match("a.json") != vector<size_t>{ 0 })
+				lb = true;
+	});
+	for (int i = 0; i < 100; i++)
+		lr.replace(glob_set{ "*.json", to_string(i) + ".v" });
+	ld = true, lt.join();
+	const auto ls = lr.acquire();
+	const auto lx = !lb && ls->size() == 2 && (*ls)[1].match("99.v");
+	cout << "Want MATCH, got " << (lx ? "MATCH (OK)" : "FAIL! (BZZZT!)") << " with 99.v -> live_rules after 100 replacements" << endl;
+
+	// ... and patterns known at compile time can be compiled [and checked] then
+	using namespace rglob::literals;
+	static_assert(("*.json"_glob).match("a.json") && !("*.json"_glob).match("a.jsonx"));
+	validateStatic<"*a?c">("abaXc");
+	validateStatic<"*a?c">("aXac", false);
+	validateStatic<"a?c*def*[^]ABx-z]*">("abcYdefABBA Van Halen");
+	validateStatic<"*[А-Я а-я][А-Я а-я][А-Я а-я]barε">("fuП фbarε");
+	validateStatic<"*[А-Я а-я]?">("fuП", false);
+	validateStatic<"*[a]??x">("фaф€x");
 	return 0;
 }
 
@@ -64,6 +284,11 @@ int main(int argc, char* argv[])
 	x	expected result of match (true -> MATCH, false -> FAIL!)
 	pp	pretty_print the compiled version of this pattern
 
+	N.B. - each match is performed with BOTH the binary (via glob) and the text
+	forms of the compiled pattern, as well as with AND without validation of the
+	target as UTF-8 (and with a copy of the glob, and a threaded_matcher), and
+	any disagreement is then reported as "BZZZT!"
+
 	N.B. - whether or not the handy "u8" from of string literals is used, both
 	the pattern and target will be interpreted as containing Unicode in UTF-8!
 */
@@ -84,13 +309,70 @@ static void validate(string_view p, string_view t, bool x, bool pp)
 		cout << "Pretty_print of " << p << ':' << endl, g.pretty_print(cout, "    ");
 	try {
 		const auto r = g.match(t);
+		// (glob uses the binary form, so ALSO check that the text form agrees)
+		compiler c;
+		c.compile(p);
+		const glob h = g;
+		const auto same = matcher(c.machine()).match(t) == r && g.match(trusted_utf8, t) == r && h.match(t) == r &&
+			threaded_matcher(g.machine()).match(t) == r;
 		cout << "Want "
 			<< mf(x) << ", got "
 			<< mf(r) << " ("
-			<< ((r != x) ? "BZZZT!" : "OK") << ") with "
+			<< ((r != x || !same) ? "BZZZT!" : "OK") << ") with "
 			<< t << " -> "
 			<< p << endl;
 	} catch (invalid_argument& e) {
 		cerr << "*** Matching " << t << " => std::invalid_argument: " << e.what() << endl;
 	}
 }
+
+/*
+	validateSet matches a target against a glob_set, and reports on whether the
+	ids of the patterns that matched it were the expected ones.
+
+	Usage
+	=====
+	s	set of [compiled] patterns to match against
+	t	target text for matching
+	x	expected ids of patterns matched (ascending)
+*/
+static void validateSet(const glob_set& s, string_view t, const vector<size_t>& x)
+{
+	auto ids = [](const vector<size_t>& v) {
+		string r;
+		for (auto id : v)
+			r += (r.empty() ? "" : " "), r += to_string(id);
+		return '{' + r + '}';
+	};
+	const auto r = s.match(t);
+	cout << "Want "
+		<< ids(x) << ", got "
+		<< ids(r) << " ("
+		<< ((r != x) ? "BZZZT!" : "OK") << ") with "
+		<< t << " -> glob_set of "
+		<< s.size() << endl;
+}
+
+/*
+	validateStatic matches a target against a pattern compiled at compile time
+	(as a static_glob), and reports on whether the match result was the expected
+	one - AND the same as for the equivalent [run time compiled] glob.
+
+	Usage
+	=====
+	P	pattern [template argument] to compile and match against
+	t	target text for matching
+	x	expected result of match (true -> MATCH, false -> FAIL!)
+*/
+template<detail::fixedString P>
+static void validateStatic(string_view t, bool x)
+{
+	auto mf = [](auto tf) { return tf ? "MATCH" : "FAIL!"; };
+	const auto r = static_glob<P>::match(t);
+	cout << "Want "
+		<< mf(x) << ", got "
+		<< mf(r) << " ("
+		<< ((r != x || glob(P.view()).match(t) != r) ? "BZZZT!" : "OK") << ") with "
+		<< t << " -> static_glob of "
+		<< P.view() << endl;
+}